@@ -49,6 +49,14 @@
 #define _PB_M POLYBENCH_LOOP_BOUND(M, m)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Tile size and row window of the tuned variant. */
+#ifndef CORRELATION_NB
+#define CORRELATION_NB 96
+#endif
+#ifndef CORRELATION_CHUNK
+#define CORRELATION_CHUNK 256
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
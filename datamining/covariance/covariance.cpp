@@ -12,9 +12,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "covariance.h"
@@ -174,6 +180,87 @@ static void kernel_covariance(INT_TYPE m, INT_TYPE n, DATA_TYPE float_n,
   polybench_GPU_array_sync_1D(mean, m);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Columns are split over the threads to compute the means, then data is
+     centered in the same parallel region. The upper triangle of
+     data^T * data is cut into COVARIANCE_NB x COVARIANCE_NB tiles of equal
+     cost, handed out dynamically; diagonal tiles go through a scratch tile
+     so that only their upper half is written. A last pass over pairs of
+     tiles scales the upper triangle and mirrors it, one tile and its
+     transpose at a time. */
+  const INT_TYPE ldd = sizeof(data[0]) / sizeof(data[0][0]);
+  const INT_TYPE ldc = sizeof(cov[0]) / sizeof(cov[0][0]);
+  const INT_TYPE nb = (m + COVARIANCE_NB - 1) / COVARIANCE_NB;
+  std::vector<double> busy(omp_get_max_threads(), 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> Ap, Bp, S(COVARIANCE_NB * COVARIANCE_NB);
+    double my_busy = 0.0;
+
+    /* Each thread owns a contiguous range of columns and streams the rows
+       over it, so the sums keep the order of the reference. */
+    {
+      const INT_TYPE nt = omp_get_num_threads(), t = omp_get_thread_num();
+      const INT_TYPE j0 = m * t / nt, j1 = m * (t + 1) / nt;
+      for (INT_TYPE j = j0; j < j1; j++)
+        mean[j] = SCALAR_VAL(0.0);
+      for (INT_TYPE i = 0; i < n; i++)
+        for (INT_TYPE j = j0; j < j1; j++)
+          mean[j] += data[i][j];
+      for (INT_TYPE j = j0; j < j1; j++)
+        mean[j] /= float_n;
+    }
+#pragma omp barrier
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < n; i++)
+#pragma omp simd
+      for (INT_TYPE j = 0; j < m; j++)
+        data[i][j] -= mean[j];
+
+#pragma omp for schedule(dynamic)
+    for (INT_TYPE t = 0; t < nb * (nb + 1) / 2; t++) {
+      const double t_start = omp_get_wtime();
+      INT_TYPE bj, bi;
+      polybench_tri_tile(t, &bj, &bi);
+      const INT_TYPE i0 = bi * COVARIANCE_NB, j0 = bj * COVARIANCE_NB;
+      const INT_TYPE jb = m - j0 < COVARIANCE_NB ? m - j0 : COVARIANCE_NB;
+      if (bi != bj) {
+        polybench_gemm_seq<DATA_TYPE>(COVARIANCE_NB, jb, n, SCALAR_VAL(1.0),
+                                      &data[0][i0], 1, ldd, &data[0][j0], ldd,
+                                      1, SCALAR_VAL(0.0), &cov[i0][j0], ldc,
+                                      Ap, Bp);
+      } else {
+        polybench_gemm_seq<DATA_TYPE>(jb, jb, n, SCALAR_VAL(1.0),
+                                      &data[0][i0], 1, ldd, &data[0][i0], ldd,
+                                      1, SCALAR_VAL(0.0), S.data(), jb, Ap,
+                                      Bp);
+        for (INT_TYPE i = 0; i < jb; i++)
+          for (INT_TYPE j = i; j < jb; j++)
+            cov[i0 + i][i0 + j] = S[i * jb + j];
+      }
+      my_busy += omp_get_wtime() - t_start;
+    }
+
+#pragma omp for schedule(dynamic)
+    for (INT_TYPE t = 0; t < nb * (nb + 1) / 2; t++) {
+      INT_TYPE bj, bi;
+      polybench_tri_tile(t, &bj, &bi);
+      const INT_TYPE i0 = bi * COVARIANCE_NB, j0 = bj * COVARIANCE_NB;
+      const INT_TYPE i1 = m - i0 < COVARIANCE_NB ? m : i0 + COVARIANCE_NB;
+      const INT_TYPE j1 = m - j0 < COVARIANCE_NB ? m : j0 + COVARIANCE_NB;
+      for (INT_TYPE i = i0; i < i1; i++)
+        for (INT_TYPE j = bi == bj ? i : j0; j < j1; j++) {
+          cov[i][j] /= (float_n - SCALAR_VAL(1.0));
+          cov[j][i] = cov[i][j];
+        }
+    }
+    busy[omp_get_thread_num()] = my_busy;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_busy(busy.data(), (int)busy.size());
 #else
   polybench_start_instruments;
 #pragma scop
@@ -49,6 +49,11 @@
 #define _PB_M POLYBENCH_LOOP_BOUND(M, m)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Tile size of the tuned variant. */
+#ifndef COVARIANCE_NB
+#define COVARIANCE_NB 96
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -15,6 +15,9 @@
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "gemm.h"
@@ -132,6 +135,28 @@ static void kernel_gemm(INT_TYPE ni, INT_TYPE nj, INT_TYPE nk, DATA_TYPE alpha,
   polybench_GPU_array_sync_2D(C, ni, nj);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Packed, cache-blocked GEMM with a register-tiled micro-kernel, see
+     utilities/polybench_gemm.h. */
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+  polybench_gemm<DATA_TYPE>(ni, nj, nk, alpha, &A[0][0],
+                            sizeof(A[0]) / sizeof(A[0][0]), 1, &B[0][0],
+                            sizeof(B[0]) / sizeof(B[0][0]), 1, beta, &C[0][0],
+                            sizeof(C[0]) / sizeof(C[0][0]));
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_gemm = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  const polybench_gemm_blocking blk =
+      polybench_gemm_get_blocking(sizeof(DATA_TYPE));
+  polybench_tuned_report("mc %ld kc %ld nc %ld, %0.2f GFLOP/s\n", blk.mc,
+                         blk.kc, blk.nc, 2.0 * ni * nj * nk / t_gemm * 1e-9);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
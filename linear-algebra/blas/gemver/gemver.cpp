@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -191,6 +194,60 @@ static void kernel_gemver(INT_TYPE n, DATA_TYPE alpha, DATA_TYPE beta,
   polybench_GPU_array_sync_1D(x, n);
   polybench_GPU_array_sync_1D(w, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Two passes over A instead of three. The first one applies the rank-2
+     update to a row and adds it, scaled by y(j), to a thread-private
+     partial of A^T y while the row is still in cache. The partials are
+     summed by polybench_tuned_sum_partials, then added to x with z. w
+     needs all of x, so the second pass is a plain row-wise GEMV. */
+  const INT_TYPE max_threads = omp_get_max_threads();
+  std::vector<DATA_TYPE> x_part(max_threads * n);
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    DATA_TYPE *xp = &x_part[omp_get_thread_num() * n];
+    for (INT_TYPE i = 0; i < n; i++)
+      xp[i] = SCALAR_VAL(0.0);
+
+#pragma omp for schedule(static)
+    for (INT_TYPE j = 0; j < n; j++) {
+      const DATA_TYPE u1j = u1[j], u2j = u2[j], yj = y[j];
+#pragma omp simd
+      for (INT_TYPE i = 0; i < n; i++) {
+        const DATA_TYPE aji = A[j][i] + u1j * v1[i] + u2j * v2[i];
+        A[j][i] = aji;
+        xp[i] += aji * yj;
+      }
+    }
+
+    polybench_tuned_sum_partials(x_part.data(), n, omp_get_num_threads());
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < n; i++)
+      x[i] += beta * x_part[i] + z[i];
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < n; i++) {
+      DATA_TYPE wi = SCALAR_VAL(0.0);
+#pragma omp simd reduction(+ : wi)
+      for (INT_TYPE j = 0; j < n; j++)
+        wi += A[i][j] * x[j];
+      w[i] += alpha * wi;
+    }
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_gemver = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  /* A is read, written and read again. */
+  polybench_tuned_report_bandwidth(
+      sizeof(DATA_TYPE) * (3.0 * n * n + 10.0 * n), t_gemver);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
@@ -12,9 +12,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "symm.h"
@@ -150,6 +156,52 @@ static void kernel_symm(INT_TYPE m, INT_TYPE n, DATA_TYPE alpha, DATA_TYPE beta,
 
   polybench_GPU_array_sync_2D(C, m, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* C is cut into SYMM_NB x SYMM_NB tiles of equal cost, handed out
+     dynamically. For row block bi, the symmetric A is read as three GEMM
+     operands: the stored rows left of the diagonal block, the diagonal
+     block made symmetric in a scratch tile, and the stored columns below
+     it, transposed. tmp is not needed. */
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const INT_TYPE ldb = sizeof(B[0]) / sizeof(B[0][0]);
+  const INT_TYPE ldc = sizeof(C[0]) / sizeof(C[0][0]);
+  const INT_TYPE nbi = (m + SYMM_NB - 1) / SYMM_NB;
+  const INT_TYPE nbj = (n + SYMM_NB - 1) / SYMM_NB;
+  std::vector<double> busy(omp_get_max_threads(), 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> Ap, Bp, S(SYMM_NB * SYMM_NB);
+    double my_busy = 0.0;
+#pragma omp for collapse(2) schedule(dynamic) nowait
+    for (INT_TYPE bi = 0; bi < nbi; bi++)
+      for (INT_TYPE bj = 0; bj < nbj; bj++) {
+        const double t_start = omp_get_wtime();
+        const INT_TYPE i0 = bi * SYMM_NB, j0 = bj * SYMM_NB;
+        const INT_TYPE i1 = i0 + SYMM_NB < m ? i0 + SYMM_NB : m;
+        const INT_TYPE ib = i1 - i0;
+        const INT_TYPE jb = n - j0 < SYMM_NB ? n - j0 : SYMM_NB;
+        for (INT_TYPE i = 0; i < ib; i++)
+          for (INT_TYPE k = 0; k <= i; k++)
+            S[i * ib + k] = S[k * ib + i] = A[i0 + i][i0 + k];
+        polybench_gemm_seq<DATA_TYPE>(ib, jb, ib, alpha, S.data(), ib, 1,
+                                      &B[i0][j0], ldb, 1, beta, &C[i0][j0],
+                                      ldc, Ap, Bp);
+        polybench_gemm_seq<DATA_TYPE>(ib, jb, i0, alpha, &A[i0][0], lda, 1,
+                                      &B[0][j0], ldb, 1, SCALAR_VAL(1.0),
+                                      &C[i0][j0], ldc, Ap, Bp);
+        polybench_gemm_seq<DATA_TYPE>(ib, jb, m - i1, alpha, &A[i1][i0], 1,
+                                      lda, &B[i1][j0], ldb, 1,
+                                      SCALAR_VAL(1.0), &C[i0][j0], ldc, Ap,
+                                      Bp);
+        my_busy += omp_get_wtime() - t_start;
+      }
+    busy[omp_get_thread_num()] = my_busy;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_busy(busy.data(), (int)busy.size());
 #else
   polybench_start_instruments;
 #pragma scop
@@ -12,9 +12,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "syr2k.h"
@@ -135,6 +141,50 @@ static void kernel_syr2k(INT_TYPE n, INT_TYPE m, DATA_TYPE alpha,
 
   polybench_GPU_array_sync_2D(C, n, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Same tiling as syrk: equal-cost tiles of the lower triangle of C,
+     handed out dynamically, each one two GEMMs (A B^T and B A^T).
+     Diagonal tiles go through a scratch tile so that only their lower
+     half is written. */
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const INT_TYPE ldb = sizeof(B[0]) / sizeof(B[0][0]);
+  const INT_TYPE ldc = sizeof(C[0]) / sizeof(C[0][0]);
+  const INT_TYPE nb = (n + SYR2K_NB - 1) / SYR2K_NB;
+  std::vector<double> busy(omp_get_max_threads(), 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> Ap, Bp, S(SYR2K_NB * SYR2K_NB);
+    double my_busy = 0.0;
+#pragma omp for schedule(dynamic) nowait
+    for (INT_TYPE t = 0; t < nb * (nb + 1) / 2; t++) {
+      const double t_start = omp_get_wtime();
+      INT_TYPE bi, bj;
+      polybench_tri_tile(t, &bi, &bj);
+      const INT_TYPE i0 = bi * SYR2K_NB, j0 = bj * SYR2K_NB;
+      const INT_TYPE ib = n - i0 < SYR2K_NB ? n - i0 : SYR2K_NB;
+      const INT_TYPE jb = bi != bj ? SYR2K_NB : ib;
+      DATA_TYPE *T = bi != bj ? &C[i0][j0] : S.data();
+      const INT_TYPE ldt = bi != bj ? ldc : ib;
+      polybench_gemm_seq<DATA_TYPE>(ib, jb, m, alpha, &A[i0][0], lda, 1,
+                                    &B[j0][0], 1, ldb,
+                                    bi != bj ? beta : SCALAR_VAL(0.0), T, ldt,
+                                    Ap, Bp);
+      polybench_gemm_seq<DATA_TYPE>(ib, jb, m, alpha, &B[i0][0], ldb, 1,
+                                    &A[j0][0], 1, lda, SCALAR_VAL(1.0), T, ldt,
+                                    Ap, Bp);
+      if (bi == bj)
+        for (INT_TYPE i = 0; i < ib; i++)
+          for (INT_TYPE j = 0; j <= i; j++)
+            C[i0 + i][i0 + j] = beta * C[i0 + i][i0 + j] + S[i * ib + j];
+      my_busy += omp_get_wtime() - t_start;
+    }
+    busy[omp_get_thread_num()] = my_busy;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_busy(busy.data(), (int)busy.size());
 #else
   polybench_start_instruments;
 #pragma scop
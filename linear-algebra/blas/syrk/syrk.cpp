@@ -12,9 +12,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "syrk.h"
@@ -125,6 +131,47 @@ static void kernel_syrk(INT_TYPE n, INT_TYPE m, DATA_TYPE alpha, DATA_TYPE beta,
 
   polybench_GPU_array_sync_2D(C, n, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* The lower triangle of C is cut into SYRK_NB x SYRK_NB tiles of equal
+     cost, handed out dynamically. Off-diagonal tiles are a GEMM with A and
+     A^T; diagonal tiles are computed in full into a scratch tile and only
+     their lower half is written back. */
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const INT_TYPE ldc = sizeof(C[0]) / sizeof(C[0][0]);
+  const INT_TYPE nb = (n + SYRK_NB - 1) / SYRK_NB;
+  std::vector<double> busy(omp_get_max_threads(), 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> Ap, Bp, S(SYRK_NB * SYRK_NB);
+    double my_busy = 0.0;
+#pragma omp for schedule(dynamic) nowait
+    for (INT_TYPE t = 0; t < nb * (nb + 1) / 2; t++) {
+      const double t_start = omp_get_wtime();
+      INT_TYPE bi, bj;
+      polybench_tri_tile(t, &bi, &bj);
+      const INT_TYPE i0 = bi * SYRK_NB, j0 = bj * SYRK_NB;
+      const INT_TYPE ib = n - i0 < SYRK_NB ? n - i0 : SYRK_NB;
+      if (bi != bj) {
+        polybench_gemm_seq<DATA_TYPE>(ib, SYRK_NB, m, alpha, &A[i0][0], lda,
+                                      1, &A[j0][0], 1, lda, beta, &C[i0][j0],
+                                      ldc, Ap, Bp);
+      } else {
+        polybench_gemm_seq<DATA_TYPE>(ib, ib, m, alpha, &A[i0][0], lda, 1,
+                                      &A[i0][0], 1, lda, SCALAR_VAL(0.0),
+                                      S.data(), ib, Ap, Bp);
+        for (INT_TYPE i = 0; i < ib; i++)
+          for (INT_TYPE j = 0; j <= i; j++)
+            C[i0 + i][i0 + j] = beta * C[i0 + i][i0 + j] + S[i * ib + j];
+      }
+      my_busy += omp_get_wtime() - t_start;
+    }
+    busy[omp_get_thread_num()] = my_busy;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_busy(busy.data(), (int)busy.size());
 #else
   polybench_start_instruments;
 #pragma scop
@@ -12,9 +12,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "trmm.h"
@@ -124,6 +130,56 @@ static void kernel_trmm(INT_TYPE m, INT_TYPE n, DATA_TYPE alpha,
 
   polybench_GPU_array_sync_2D(B, m, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* B is cut into tiles of TRMM_NB rows by TRMM_NB columns. Tile (bi, bj)
+     applies the unit triangle of the diagonal block of A in place, top
+     down, then the stored rows of A below it as one transposed GEMM
+     against the rows of B below the tile. These rows are read from a copy
+     B0 of the original B, as other tiles of the strip overwrite them, so
+     that every tile is independent. The cost of a tile grows with the
+     number of rows below it: the tiles are handed out dynamically, the
+     top (most expensive) row blocks first. */
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const INT_TYPE ldb = sizeof(B[0]) / sizeof(B[0][0]);
+  const INT_TYPE nbi = (m + TRMM_NB - 1) / TRMM_NB;
+  const INT_TYPE nbj = (n + TRMM_NB - 1) / TRMM_NB;
+  std::vector<DATA_TYPE> B0(m * n);
+  std::vector<double> busy(omp_get_max_threads(), 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> Ap, Bp;
+    double my_busy = 0.0;
+#pragma omp for schedule(static)
+    for (INT_TYPE i = TRMM_NB < m ? TRMM_NB : m; i < m; i++)
+      for (INT_TYPE j = 0; j < n; j++)
+        B0[i * n + j] = B[i][j];
+
+#pragma omp for schedule(dynamic) nowait
+    for (INT_TYPE t = 0; t < nbi * nbj; t++) {
+      const double t_start = omp_get_wtime();
+      const INT_TYPE i0 = t / nbj * TRMM_NB, j0 = t % nbj * TRMM_NB;
+      const INT_TYPE i1 = i0 + TRMM_NB < m ? i0 + TRMM_NB : m;
+      const INT_TYPE j1 = j0 + TRMM_NB < n ? j0 + TRMM_NB : n;
+      for (INT_TYPE i = i0; i < i1; i++) {
+        for (INT_TYPE k = i + 1; k < i1; k++)
+          for (INT_TYPE j = j0; j < j1; j++)
+            B[i][j] += A[k][i] * B[k][j];
+        for (INT_TYPE j = j0; j < j1; j++)
+          B[i][j] *= alpha;
+      }
+      polybench_gemm_seq<DATA_TYPE>(i1 - i0, j1 - j0, m - i1, alpha,
+                                    &A[i1][i0], 1, lda, &B0[i1 * n + j0], n,
+                                    1, SCALAR_VAL(1.0), &B[i0][j0], ldb, Ap,
+                                    Bp);
+      my_busy += omp_get_wtime() - t_start;
+    }
+    busy[omp_get_thread_num()] = my_busy;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_busy(busy.data(), (int)busy.size());
 #else
   polybench_start_instruments;
 #pragma scop
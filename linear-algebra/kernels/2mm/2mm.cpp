@@ -12,9 +12,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "2mm.h"
@@ -63,7 +69,9 @@ static void print_array(INT_TYPE ni, INT_TYPE nl,
    including the call and return. */
 static void kernel_2mm(INT_TYPE ni, INT_TYPE nj, INT_TYPE nk, INT_TYPE nl,
                        DATA_TYPE alpha, DATA_TYPE beta,
+#if !defined(POLYBENCH_TUNED)
                        ARRAY_2D_FUNC_PARAM(DATA_TYPE, tmp, NI, NJ, ni, nj),
+#endif
                        ARRAY_2D_FUNC_PARAM(DATA_TYPE, A, NI, NK, ni, nk),
                        ARRAY_2D_FUNC_PARAM(DATA_TYPE, B, NK, NJ, nk, nj),
                        ARRAY_2D_FUNC_PARAM(DATA_TYPE, C, NJ, NL, nj, nl),
@@ -173,6 +181,54 @@ static void kernel_2mm(INT_TYPE ni, INT_TYPE nj, INT_TYPE nk, INT_TYPE nl,
   polybench_GPU_array_sync_2D(D, ni, nl);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* tmp is never materialized: each block of mb rows of alpha*A*B goes to
+     an mb x nj scratch buffer T, which stays in cache and is consumed right
+     away into the same rows of D. B and C are packed once for all the row
+     blocks. Both products use utilities/polybench_gemm.h. */
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const INT_TYPE ldb = sizeof(B[0]) / sizeof(B[0][0]);
+  const INT_TYPE ldc = sizeof(C[0]) / sizeof(C[0][0]);
+  const INT_TYPE ldd = sizeof(D[0]) / sizeof(D[0][0]);
+  INT_TYPE mb = TWOMM_MB;
+  if (mb == 0) {
+    const long l2 = polybench_cache_size(_SC_LEVEL2_CACHE_SIZE, 256 << 10);
+    mb = l2 / (nj * sizeof(DATA_TYPE)) / POLYBENCH_GEMM_MR *
+         POLYBENCH_GEMM_MR;
+    if (mb < POLYBENCH_GEMM_MR)
+      mb = POLYBENCH_GEMM_MR;
+  }
+  if (mb > ni)
+    mb = ni;
+  std::vector<DATA_TYPE> T(mb * nj);
+  polybench_gemm_packed_b<DATA_TYPE> Bp, Cp;
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+  polybench_gemm_pack_b_all<DATA_TYPE>(nk, nj, &B[0][0], ldb, 1, Bp);
+  polybench_gemm_pack_b_all<DATA_TYPE>(nj, nl, &C[0][0], ldc, 1, Cp);
+  for (INT_TYPE ib = 0; ib < ni; ib += mb) {
+    const INT_TYPE m = ni - ib < mb ? ni - ib : mb;
+    polybench_gemm_packed<DATA_TYPE>(m, alpha, &A[ib][0], lda, 1, Bp,
+                                     SCALAR_VAL(0.0), T.data(), nj);
+    polybench_gemm_packed<DATA_TYPE>(m, SCALAR_VAL(1.0), T.data(), nj, 1,
+                                     Cp, beta, &D[ib][0], ldd);
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_2mm = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report("row block %lu (%0.2f MB of tmp used instead of "
+                         "%0.2f MB), %0.2f GFLOP/s, peak RSS %0.2f MB\n",
+                         mb, mb * nj * sizeof(DATA_TYPE) / 1e6,
+                         ni * nj * sizeof(DATA_TYPE) / 1e6,
+                         2.0 * ni * (nj * nk + nl * nj) / t_2mm * 1e-9,
+                         polybench_tuned_peak_rss() / 1e6);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
@@ -207,7 +263,9 @@ int main(int argc, char **argv) {
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
   DATA_TYPE beta;
+#if !defined(POLYBENCH_TUNED)
   POLYBENCH_2D_ARRAY_DECL(tmp, DATA_TYPE, NI, NJ, ni, nj);
+#endif
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, NI, NK, ni, nk);
   POLYBENCH_2D_ARRAY_DECL(B, DATA_TYPE, NK, NJ, nk, nj);
   POLYBENCH_2D_ARRAY_DECL(C, DATA_TYPE, NJ, NL, nj, nl);
@@ -218,7 +276,10 @@ int main(int argc, char **argv) {
              POLYBENCH_ARRAY(B), POLYBENCH_ARRAY(C), POLYBENCH_ARRAY(D));
 
   /* Run kernel. */
-  kernel_2mm(ni, nj, nk, nl, alpha, beta, POLYBENCH_ARRAY(tmp),
+  kernel_2mm(ni, nj, nk, nl, alpha, beta,
+#if !defined(POLYBENCH_TUNED)
+             POLYBENCH_ARRAY(tmp),
+#endif
              POLYBENCH_ARRAY(A), POLYBENCH_ARRAY(B), POLYBENCH_ARRAY(C),
              POLYBENCH_ARRAY(D));
 
@@ -229,7 +290,9 @@ int main(int argc, char **argv) {
   polybench_prevent_dce(print_array(ni, nl, POLYBENCH_ARRAY(D)));
 
   /* Be clean. */
+#if !defined(POLYBENCH_TUNED)
   POLYBENCH_FREE_ARRAY(tmp);
+#endif
   POLYBENCH_FREE_ARRAY(A);
   POLYBENCH_FREE_ARRAY(B);
   POLYBENCH_FREE_ARRAY(C);
@@ -61,6 +61,12 @@
 #define _PB_NK POLYBENCH_LOOP_BOUND(NK, nk)
 #define _PB_NL POLYBENCH_LOOP_BOUND(NL, nl)
 
+/* Rows of tmp computed and consumed at a time by the tuned variant. 0 sizes
+   the row block so that it fits in the L2 cache. */
+#ifndef TWOMM_MB
+#define TWOMM_MB 0
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -12,9 +12,19 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED)
+#include <polybench_gemm.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "3mm.h"
@@ -57,6 +67,15 @@ static void print_array(INT_TYPE ni, INT_TYPE nl,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Spin until a panel of E or F has been computed. */
+static inline void wait_panel(const std::atomic<int> &ready) {
+  for (INT_TYPE spin = 0; !ready.load(std::memory_order_acquire); spin++)
+    if (spin > 1024)
+      std::this_thread::yield();
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_3mm(INT_TYPE ni, INT_TYPE nj, INT_TYPE nk, INT_TYPE nl,
@@ -210,6 +229,129 @@ static void kernel_3mm(INT_TYPE ni, INT_TYPE nj, INT_TYPE nk, INT_TYPE nl,
   polybench_GPU_array_sync_2D(F, nj, nl);
   polybench_GPU_array_sync_2D(G, ni, nl);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Task graph: the row panels of E and the column panels of F are computed
+     concurrently by two thread groups, sized after the flop count of each
+     product. Tile (bi, bj) of G starts as soon as row panel bi of E and
+     column panel bj of F are ready, so there is no barrier between the
+     products. A thread that runs out of panels in its group helps the
+     other group, then moves on to G. */
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const INT_TYPE ldb = sizeof(B[0]) / sizeof(B[0][0]);
+  const INT_TYPE ldc = sizeof(C[0]) / sizeof(C[0][0]);
+  const INT_TYPE ldd = sizeof(D[0]) / sizeof(D[0][0]);
+  const INT_TYPE lde = sizeof(E[0]) / sizeof(E[0][0]);
+  const INT_TYPE ldf = sizeof(F[0]) / sizeof(F[0][0]);
+  const INT_TYPE ldg = sizeof(G[0]) / sizeof(G[0][0]);
+  const INT_TYPE nbe = (ni + THREEMM_TB - 1) / THREEMM_TB;
+  const INT_TYPE nbf = (nl + THREEMM_TB - 1) / THREEMM_TB;
+  std::vector<std::atomic<int>> e_ready(nbe), f_ready(nbf);
+  for (INT_TYPE b = 0; b < nbe; b++)
+    e_ready[b].store(0, std::memory_order_relaxed);
+  for (INT_TYPE b = 0; b < nbf; b++)
+    f_ready[b].store(0, std::memory_order_relaxed);
+
+  /* G tiles, in the order in which their panels are expected to be done. */
+  std::vector<std::pair<INT_TYPE, INT_TYPE>> tiles;
+  for (INT_TYPE bi = 0; bi < nbe; bi++)
+    for (INT_TYPE bj = 0; bj < nbf; bj++)
+      tiles.push_back(std::make_pair(bi, bj));
+  std::stable_sort(tiles.begin(), tiles.end(),
+                   [=](const std::pair<INT_TYPE, INT_TYPE> &a,
+                       const std::pair<INT_TYPE, INT_TYPE> &b) {
+                     return std::max((a.first + 1) * nbf, (a.second + 1) * nbe) <
+                            std::max((b.first + 1) * nbf, (b.second + 1) * nbe);
+                   });
+
+  std::atomic<INT_TYPE> next_e(0), next_f(0), next_g(0);
+#if defined(POLYBENCH_TUNED_REPORT)
+  std::atomic<INT_TYPE> panels_done(0), g_early(0);
+  int e_threads = 1, f_threads = 0;
+  double t_panels = 0.0;
+#endif
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    const int nthreads = omp_get_num_threads();
+    const double flops_e = (double)ni * nj * nk;
+    const double flops_f = (double)nj * nl * nm;
+    int ne = (int)(nthreads * flops_e / (flops_e + flops_f) + 0.5);
+    ne = ne < 1 ? 1 : ne;
+    if (nthreads > 1 && ne > nthreads - 1)
+      ne = nthreads - 1;
+#if defined(POLYBENCH_TUNED_REPORT)
+#pragma omp master
+    {
+      e_threads = ne;
+      f_threads = nthreads - ne;
+    }
+#endif
+    const bool in_e = omp_get_thread_num() < ne;
+    std::vector<DATA_TYPE> Ap, Bp;
+
+    /* Own group first, then the other one. */
+    for (int pass = 0; pass < 2; pass++) {
+      const bool do_e = (pass == 0) == in_e;
+      std::atomic<INT_TYPE> &next = do_e ? next_e : next_f;
+      const INT_TYPE nb = do_e ? nbe : nbf;
+      for (INT_TYPE b; (b = next.fetch_add(1)) < nb;) {
+        const INT_TYPE b0 = b * THREEMM_TB;
+        if (do_e) {
+          const INT_TYPE bs = ni - b0 < THREEMM_TB ? ni - b0 : THREEMM_TB;
+          polybench_gemm_seq<DATA_TYPE>(
+              bs, nj, nk, SCALAR_VAL(1.0), &A[b0][0], lda, 1, &B[0][0], ldb,
+              1, SCALAR_VAL(0.0), &E[b0][0], lde, Ap, Bp);
+          e_ready[b].store(1, std::memory_order_release);
+        } else {
+          const INT_TYPE bs = nl - b0 < THREEMM_TB ? nl - b0 : THREEMM_TB;
+          polybench_gemm_seq<DATA_TYPE>(
+              nj, bs, nm, SCALAR_VAL(1.0), &C[0][0], ldc, 1, &D[0][b0], ldd,
+              1, SCALAR_VAL(0.0), &F[0][b0], ldf, Ap, Bp);
+          f_ready[b].store(1, std::memory_order_release);
+        }
+#if defined(POLYBENCH_TUNED_REPORT)
+        if (panels_done.fetch_add(1) + 1 == nbe + nbf)
+          t_panels = omp_get_wtime() - t_start;
+#endif
+      }
+    }
+
+    for (INT_TYPE t; (t = next_g.fetch_add(1)) < tiles.size();) {
+      const INT_TYPE bi = tiles[t].first, bj = tiles[t].second;
+#if defined(POLYBENCH_TUNED_REPORT)
+      if (panels_done.load(std::memory_order_relaxed) < nbe + nbf)
+        g_early.fetch_add(1, std::memory_order_relaxed);
+#endif
+      wait_panel(e_ready[bi]);
+      wait_panel(f_ready[bj]);
+      const INT_TYPE i0 = bi * THREEMM_TB, j0 = bj * THREEMM_TB;
+      polybench_gemm_seq<DATA_TYPE>(
+          ni - i0 < THREEMM_TB ? ni - i0 : THREEMM_TB,
+          nl - j0 < THREEMM_TB ? nl - j0 : THREEMM_TB, nj, SCALAR_VAL(1.0),
+          &E[i0][0], lde, 1, &F[0][j0], ldf, 1, SCALAR_VAL(0.0), &G[i0][j0],
+          ldg, Ap, Bp);
+    }
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_3mm = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report("E %lu panels / %d threads, F %lu panels / %d "
+                         "threads, %lu of %lu G tiles started before E and F "
+                         "were complete\n",
+                         nbe, e_threads, nbf, f_threads, g_early.load(),
+                         (INT_TYPE)tiles.size());
+  polybench_tuned_report("E and F done at %f s, total %f s, %0.2f GFLOP/s\n",
+                         t_panels, t_3mm,
+                         2.0 * (ni * nj * nk + nj * nl * nm + ni * nl * nj) /
+                             t_3mm * 1e-9);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
@@ -67,6 +67,12 @@
 #define _PB_NL POLYBENCH_LOOP_BOUND(NL, nl)
 #define _PB_NM POLYBENCH_LOOP_BOUND(NM, nm)
 
+/* Panel width of the tuned variant: E is computed by row panels, F by
+   column panels and G by TB x TB tiles. */
+#ifndef THREEMM_TB
+#define THREEMM_TB 192
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -148,6 +151,49 @@ static void kernel_atax(INT_TYPE m, INT_TYPE n,
   polybench_GPU_array_sync_1D(tmp, m);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Single pass over A: each row gives tmp(i), then is added, while it is
+     still in cache, to a thread-private partial of y. The partials are
+     then summed by polybench_tuned_sum_partials. */
+  const INT_TYPE max_threads = omp_get_max_threads();
+  std::vector<DATA_TYPE> y_part(max_threads * n);
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    DATA_TYPE *yp = &y_part[omp_get_thread_num() * n];
+    for (INT_TYPE j = 0; j < n; j++)
+      yp[j] = SCALAR_VAL(0.0);
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < m; i++) {
+      DATA_TYPE ti = SCALAR_VAL(0.0);
+#pragma omp simd reduction(+ : ti)
+      for (INT_TYPE j = 0; j < n; j++)
+        ti += A[i][j] * x[j];
+      tmp[i] = ti;
+#pragma omp simd
+      for (INT_TYPE j = 0; j < n; j++)
+        yp[j] += A[i][j] * ti;
+    }
+
+    polybench_tuned_sum_partials(y_part.data(), n, omp_get_num_threads());
+#pragma omp for schedule(static)
+    for (INT_TYPE j = 0; j < n; j++)
+      y[j] = y_part[j];
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_atax = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report_bandwidth(sizeof(DATA_TYPE) * (m * n + 2.0 * n + m),
+                                   t_atax);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
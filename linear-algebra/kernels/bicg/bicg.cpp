@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -155,6 +158,38 @@ static void kernel_bicg(INT_TYPE m, INT_TYPE n,
   polybench_GPU_array_sync_1D(s, m);
   polybench_GPU_array_sync_1D(q, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Single pass over A: each row yields q(i) and is accumulated into a
+     thread-private partial of s. The partials are then summed by
+     polybench_tuned_sum_partials. */
+  const INT_TYPE max_threads = omp_get_max_threads();
+  std::vector<DATA_TYPE> s_part(max_threads * m);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    DATA_TYPE *sp = &s_part[omp_get_thread_num() * m];
+    for (INT_TYPE j = 0; j < m; j++)
+      sp[j] = SCALAR_VAL(0.0);
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < n; i++) {
+      const DATA_TYPE ri = r[i];
+      DATA_TYPE qi = SCALAR_VAL(0.0);
+#pragma omp simd reduction(+ : qi)
+      for (INT_TYPE j = 0; j < m; j++) {
+        sp[j] += ri * A[i][j];
+        qi += A[i][j] * p[j];
+      }
+      q[i] = qi;
+    }
+
+    polybench_tuned_sum_partials(s_part.data(), m, omp_get_num_threads());
+#pragma omp for schedule(static)
+    for (INT_TYPE j = 0; j < m; j++)
+      s[j] = s_part[j];
+  }
+  polybench_stop_instruments;
 #else
   polybench_start_instruments;
 #pragma scop
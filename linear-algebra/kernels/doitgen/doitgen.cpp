@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -52,6 +55,51 @@ static void print_array(INT_TYPE nr, INT_TYPE nq, INT_TYPE np,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* A(i, p0 .. p0 + pb) = x(i, :) * C4(:, p0 .. p0 + pb) for the rows of one
+   task, four rows at a time so that every row of C4 loaded from cache is
+   used four times. NPC and PBC are the compile-time values of np and pb,
+   or 0 for the generic kernel. */
+template <INT_TYPE NPC, INT_TYPE PBC>
+static void doitgen_rows(INT_TYPE rows, INT_TYPE np_rt, INT_TYPE p0,
+                         INT_TYPE pb_rt, const DATA_TYPE *x, DATA_TYPE *A,
+                         INT_TYPE lda, const DATA_TYPE *C4, INT_TYPE ldc4) {
+  const INT_TYPE np = NPC ? NPC : np_rt;
+  const INT_TYPE pb = PBC ? PBC : pb_rt;
+  INT_TYPE i = 0;
+  for (; i + 4 <= rows; i += 4) {
+    DATA_TYPE *o0 = &A[i * lda + p0], *o1 = o0 + lda;
+    DATA_TYPE *o2 = o1 + lda, *o3 = o2 + lda;
+    for (INT_TYPE p = 0; p < pb; p++)
+      o0[p] = o1[p] = o2[p] = o3[p] = SCALAR_VAL(0.0);
+    for (INT_TYPE s = 0; s < np; s++) {
+      const DATA_TYPE a0 = x[i * np + s], a1 = x[(i + 1) * np + s];
+      const DATA_TYPE a2 = x[(i + 2) * np + s], a3 = x[(i + 3) * np + s];
+      const DATA_TYPE *c = &C4[s * ldc4 + p0];
+#pragma omp simd
+      for (INT_TYPE p = 0; p < pb; p++) {
+        o0[p] += a0 * c[p];
+        o1[p] += a1 * c[p];
+        o2[p] += a2 * c[p];
+        o3[p] += a3 * c[p];
+      }
+    }
+  }
+  for (; i < rows; i++) {
+    DATA_TYPE *o = &A[i * lda + p0];
+    for (INT_TYPE p = 0; p < pb; p++)
+      o[p] = SCALAR_VAL(0.0);
+    for (INT_TYPE s = 0; s < np; s++) {
+      const DATA_TYPE a = x[i * np + s];
+      const DATA_TYPE *c = &C4[s * ldc4 + p0];
+#pragma omp simd
+      for (INT_TYPE p = 0; p < pb; p++)
+        o[p] += a * c[p];
+    }
+  }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 void kernel_doitgen(INT_TYPE nr, INT_TYPE nq, INT_TYPE np,
@@ -136,6 +184,64 @@ void kernel_doitgen(INT_TYPE nr, INT_TYPE nq, INT_TYPE np,
   polybench_GPU_array_sync_1D(sum, np);
   polybench_GPU_array_sync_3D(A, nr, nq, np);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* NR * NQ independent vector-matrix products against the same C4, i.e. a
+     batch of NR small GEMMs. Tasks of DOITGEN_QB rows of A are spread over
+     the threads. Each task copies its rows to a private buffer, then
+     sweeps C4 by column blocks that stay in L2. When np is the NP the
+     benchmark was compiled for, the kernel is instantiated with np (and,
+     if C4 fits in a single block, the block width) as compile-time
+     constants. */
+  const INT_TYPE lda = sizeof(A[0][0]) / sizeof(A[0][0][0]);
+  const INT_TYPE ldc4 = sizeof(C4[0]) / sizeof(C4[0][0]);
+  const INT_TYPE nbq = (nq + DOITGEN_QB - 1) / DOITGEN_QB;
+  const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE) > 0
+                      ? sysconf(_SC_LEVEL2_CACHE_SIZE)
+                      : 256 << 10;
+  INT_TYPE pb_max = l2 / 2 / (np * sizeof(DATA_TYPE)) / 8 * 8;
+  pb_max = pb_max < 8 ? 8 : pb_max > np ? np : pb_max;
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> x(DOITGEN_QB * np);
+#pragma omp for collapse(2) schedule(static)
+    for (INT_TYPE r = 0; r < nr; r++)
+      for (INT_TYPE bq = 0; bq < nbq; bq++) {
+        const INT_TYPE q0 = bq * DOITGEN_QB;
+        const INT_TYPE rows = nq - q0 < DOITGEN_QB ? nq - q0 : DOITGEN_QB;
+        for (INT_TYPE i = 0; i < rows; i++)
+          for (INT_TYPE s = 0; s < np; s++)
+            x[i * np + s] = A[r][q0 + i][s];
+        for (INT_TYPE p0 = 0; p0 < np; p0 += pb_max) {
+          const INT_TYPE pb = np - p0 < pb_max ? np - p0 : pb_max;
+          if (np == NP && pb == NP)
+            doitgen_rows<NP, NP>(rows, np, p0, pb, x.data(), &A[r][q0][0],
+                                 lda, &C4[0][0], ldc4);
+          else if (np == NP)
+            doitgen_rows<NP, 0>(rows, np, p0, pb, x.data(), &A[r][q0][0], lda,
+                                &C4[0][0], ldc4);
+          else
+            doitgen_rows<0, 0>(rows, np, p0, pb, x.data(), &A[r][q0][0], lda,
+                               &C4[0][0], ldc4);
+        }
+      }
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_doitgen = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report("%s kernel, C4 column block %lu (%0.2f MB), "
+                         "%0.2f GFLOP/s\n",
+                         np == NP ? "specialized" : "generic", pb_max,
+                         np * pb_max * sizeof(DATA_TYPE) / 1e6,
+                         2.0 * nr * nq * np * np / t_doitgen * 1e-9);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
@@ -55,6 +55,11 @@
 #define _PB_NR POLYBENCH_LOOP_BOUND(NR, nr)
 #define _PB_NP POLYBENCH_LOOP_BOUND(NP, np)
 
+/* Rows A[r][q0 .. q0 + QB) handled as one task by the tuned variant. */
+#ifndef DOITGEN_QB
+#define DOITGEN_QB 32
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
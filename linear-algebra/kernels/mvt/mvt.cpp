@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -152,6 +155,49 @@ static void kernel_mvt(INT_TYPE n, ARRAY_1D_FUNC_PARAM(DATA_TYPE, x1, N, n),
   polybench_GPU_array_sync_1D(x1, n);
   polybench_GPU_array_sync_1D(x2, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Single pass over A: row i gives the dot product for x1(i) and is added,
+     scaled by y_2(i), to a thread-private partial of x2. The partials are
+     then summed by polybench_tuned_sum_partials. */
+  const INT_TYPE max_threads = omp_get_max_threads();
+  std::vector<DATA_TYPE> x2_part(max_threads * n);
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    DATA_TYPE *xp = &x2_part[omp_get_thread_num() * n];
+    for (INT_TYPE j = 0; j < n; j++)
+      xp[j] = SCALAR_VAL(0.0);
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < n; i++) {
+      const DATA_TYPE yi = y_2[i];
+      DATA_TYPE x1i = x1[i];
+#pragma omp simd reduction(+ : x1i)
+      for (INT_TYPE j = 0; j < n; j++) {
+        x1i += A[i][j] * y_1[j];
+        xp[j] += A[i][j] * yi;
+      }
+      x1[i] = x1i;
+    }
+
+    polybench_tuned_sum_partials(x2_part.data(), n, omp_get_num_threads());
+#pragma omp for schedule(static)
+    for (INT_TYPE j = 0; j < n; j++)
+      x2[j] += x2_part[j];
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_mvt = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report_bandwidth(sizeof(DATA_TYPE) * (n * n + 6.0 * n),
+                                   t_mvt);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
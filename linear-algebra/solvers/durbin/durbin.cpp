@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -166,6 +169,95 @@ static void kernel_durbin(INT_TYPE n, ARRAY_1D_FUNC_PARAM(DATA_TYPE, r, N, n),
   polybench_GPU_array_sync_1D(z, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* The y update pairs y(i) with y(k - i - 1), so it is done in place on
+     symmetric pairs and z is not needed. Past DURBIN_SERIAL_K, a single
+     thread team runs the whole recursion with one barrier per step: each
+     thread updates its pairs and, while they are in registers, already
+     accumulates its partial of the next dot product. After the barrier
+     every thread sums the partials in the same order, so all of them get
+     the same alpha without a second barrier. The partials are double
+     buffered on the parity of k. */
+  const INT_TYPE pad = 64 / sizeof(DATA_TYPE);
+  const INT_TYPE max_threads = omp_get_max_threads();
+  const INT_TYPE k0 = DURBIN_SERIAL_K < n ? DURBIN_SERIAL_K : n;
+  std::vector<DATA_TYPE> partial(2 * max_threads * pad);
+  DATA_TYPE alpha;
+  DATA_TYPE beta;
+
+  y[0] = -r[0];
+  beta = SCALAR_VAL(1.0);
+  alpha = -r[0];
+
+  polybench_start_instruments;
+  for (INT_TYPE k = 1; k < k0; k++) {
+    beta = (1 - alpha * alpha) * beta;
+    DATA_TYPE sum = SCALAR_VAL(0.0);
+    for (INT_TYPE i = 0; i < k; i++)
+      sum += r[k - i - 1] * y[i];
+    alpha = -(r[k] + sum) / beta;
+
+    for (INT_TYPE i = 0; i < (k + 1) / 2; i++) {
+      const DATA_TYPE yi = y[i], yp = y[k - i - 1];
+      y[i] = yi + alpha * yp;
+      y[k - i - 1] = yp + alpha * yi;
+    }
+    y[k] = alpha;
+  }
+
+  if (k0 < n) {
+#pragma omp parallel firstprivate(alpha, beta)
+    {
+      const INT_TYPE tid = omp_get_thread_num();
+      const INT_TYPE nthreads = omp_get_num_threads();
+
+      DATA_TYPE sum = SCALAR_VAL(0.0);
+      for (INT_TYPE i = k0 * tid / nthreads; i < k0 * (tid + 1) / nthreads;
+           i++)
+        sum += r[k0 - i - 1] * y[i];
+      partial[((k0 % 2) * max_threads + tid) * pad] = sum;
+
+      for (INT_TYPE k = k0; k < n; k++) {
+#pragma omp barrier
+        const DATA_TYPE *part = &partial[(k % 2) * max_threads * pad];
+        sum = SCALAR_VAL(0.0);
+        for (INT_TYPE t = 0; t < nthreads; t++)
+          sum += part[t * pad];
+        beta = (1 - alpha * alpha) * beta;
+        alpha = -(r[k] + sum) / beta;
+
+        const INT_TYPE half = (k + 1) / 2;
+        DATA_TYPE next = SCALAR_VAL(0.0);
+        for (INT_TYPE i = half * tid / nthreads;
+             i < half * (tid + 1) / nthreads; i++) {
+          const INT_TYPE ip = k - i - 1;
+          const DATA_TYPE yi = y[i], yp = y[ip];
+          if (ip != i) {
+            y[i] = yi + alpha * yp;
+            y[ip] = yp + alpha * yi;
+            next += r[k - i] * y[i] + r[k - ip] * y[ip];
+          } else {
+            y[i] = yi + alpha * yi;
+            next += r[k - i] * y[i];
+          }
+        }
+        if (tid == 0) {
+          y[k] = alpha;
+          next += r[0] * alpha;
+        }
+        partial[(((k + 1) % 2) * max_threads + tid) * pad] = next;
+      }
+    }
+  }
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  const INT_TYPE launches = 3 * (n - 1);
+  polybench_tuned_report("%lu kernel launches replaced by 1 parallel region "
+                         "and %lu barriers, ~%0.6f s of fork/join avoided\n",
+                         launches, n - k0,
+                         launches * polybench_tuned_fork_join_cost());
+#endif
 #else
   DATA_TYPE z[N];
   DATA_TYPE alpha;
@@ -43,6 +43,12 @@
 
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* First k handled by the thread team in the tuned variant, the steps
+   below it are too small to be worth a barrier. */
+#ifndef DURBIN_SERIAL_K
+#define DURBIN_SERIAL_K 1024
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
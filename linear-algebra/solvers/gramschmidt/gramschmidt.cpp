@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -63,6 +66,39 @@ static void print_array(INT_TYPE m, INT_TYPE n,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Classical Gram-Schmidt projection of the b columns of W against the c
+   orthonormal columns of V, both column-major with m rows:
+   S = V^T W, then W -= V S. S is c x b, row-major. Called by every
+   thread of the enclosing parallel region, which share the work. */
+static void bcgs_project(INT_TYPE m, INT_TYPE c, INT_TYPE b,
+                         const DATA_TYPE *V, DATA_TYPE *W, DATA_TYPE *S) {
+  if (c == 0)
+    return;
+#pragma omp for schedule(static)
+  for (INT_TYPE k = 0; k < c; k++)
+    for (INT_TYPE j = 0; j < b; j++) {
+      DATA_TYPE s = SCALAR_VAL(0.0);
+#pragma omp simd reduction(+ : s)
+      for (INT_TYPE i = 0; i < m; i++)
+        s += V[k * m + i] * W[j * m + i];
+      S[k * b + j] = s;
+    }
+
+#pragma omp for schedule(static)
+  for (INT_TYPE ib = 0; ib < m; ib += GRAMSCHMIDT_MB) {
+    const INT_TYPE ie = ib + GRAMSCHMIDT_MB < m ? ib + GRAMSCHMIDT_MB : m;
+    for (INT_TYPE j = 0; j < b; j++)
+      for (INT_TYPE k = 0; k < c; k++) {
+        const DATA_TYPE s = S[k * b + j];
+#pragma omp simd
+        for (INT_TYPE i = ib; i < ie; i++)
+          W[j * m + i] -= V[k * m + i] * s;
+      }
+  }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 /* QR Decomposition with Modified Gram Schmidt:
@@ -189,6 +225,119 @@ static void kernel_gramschmidt(INT_TYPE m, INT_TYPE n,
   polybench_GPU_array_sync_2D(Q, m, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Block classical Gram-Schmidt with reorthogonalization (BCGS2) on a
+     column-major copy W of A. Each panel of GRAMSCHMIDT_NB columns is
+     projected twice against all previous columns with matrix-matrix
+     products, then orthogonalized column by column with CGS2 inside the
+     panel. W ends up holding the independent columns of Q; A is left
+     unchanged. The whole factorization runs in one parallel region: the
+     threads walk the panels and columns together, with a barrier between
+     the steps of a column instead of a fork/join. */
+  std::vector<DATA_TYPE> W(m * n);
+  std::vector<DATA_TYPE> S(n * GRAMSCHMIDT_NB);
+  std::vector<DATA_TYPE> a_nrm(n);
+  std::vector<char> indep(n);
+  DATA_TYPE nrm, scale;
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+#pragma omp for schedule(static) nowait
+    for (INT_TYPE j = 0; j < n; j++) {
+      a_nrm[j] = SCALAR_VAL(0.0);
+      for (INT_TYPE i = 0; i < m; i++) {
+        W[j * m + i] = A[i][j];
+        a_nrm[j] += A[i][j] * A[i][j];
+      }
+    }
+#pragma omp for schedule(static)
+    for (INT_TYPE k = 0; k < n; k++)
+      for (INT_TYPE j = k; j < n; j++)
+        R[k][j] = SCALAR_VAL(0.0);
+
+    for (INT_TYPE kb = 0; kb < n; kb += GRAMSCHMIDT_NB) {
+      const INT_TYPE b = kb + GRAMSCHMIDT_NB < n ? GRAMSCHMIDT_NB : n - kb;
+      DATA_TYPE *P = &W[kb * m];
+
+      for (int pass = 0; pass < 2; pass++) {
+        bcgs_project(m, kb, b, W.data(), P, S.data());
+#pragma omp single
+        for (INT_TYPE k = 0; k < kb; k++)
+          for (INT_TYPE j = 0; j < b; j++)
+            R[k][kb + j] += S[k * b + j];
+      }
+
+      for (INT_TYPE j = 0; j < b; j++) {
+        DATA_TYPE *w = &P[j * m];
+        for (int pass = 0; pass < 2; pass++) {
+          bcgs_project(m, j, 1, P, w, S.data());
+#pragma omp single
+          for (INT_TYPE k = 0; k < j; k++)
+            R[kb + k][kb + j] += S[k];
+        }
+
+#pragma omp single
+        nrm = SCALAR_VAL(0.0);
+#pragma omp for simd schedule(static) reduction(+ : nrm)
+        for (INT_TYPE i = 0; i < m; i++)
+          nrm += w[i] * w[i];
+
+        /* A numerically dependent column leaves only rounding noise, which
+           is far from orthogonal to the previous columns once normalized
+           and would corrupt the classical projections of the next ones.
+           It is thus removed from W, and its Q column is normalized as in
+           the reference, or set to zero with GRAMSCHMIDT_DEFLATE. */
+#pragma omp single
+        {
+          R[kb + j][kb + j] = SQRT_FUN(nrm);
+          indep[kb + j] =
+              nrm > GRAMSCHMIDT_DEP_TOL * GRAMSCHMIDT_DEP_TOL * a_nrm[kb + j];
+          scale = indep[kb + j] ? SCALAR_VAL(1.0) / R[kb + j][kb + j]
+                                : SCALAR_VAL(0.0);
+          if (!indep[kb + j])
+            for (INT_TYPE i = 0; i < m; i++)
+#if defined(GRAMSCHMIDT_DEFLATE)
+              Q[i][kb + j] = SCALAR_VAL(0.0);
+#else
+              Q[i][kb + j] = w[i] / R[kb + j][kb + j];
+#endif
+        }
+#pragma omp for simd schedule(static)
+        for (INT_TYPE i = 0; i < m; i++)
+          w[i] = w[i] * scale;
+      }
+    }
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < m; i++)
+      for (INT_TYPE j = 0; j < n; j++)
+        if (indep[j])
+          Q[i][j] = W[j * m + i];
+  }
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  /* A is rank deficient (n may exceed m), the dependent columns of Q are
+     left out of the error. */
+  std::vector<INT_TYPE> cols;
+  for (INT_TYPE j = 0; j < n; j++)
+    if (indep[j])
+      cols.push_back(j);
+
+  DATA_TYPE ortho = SCALAR_VAL(0.0);
+#pragma omp parallel for schedule(dynamic) reduction(max : ortho)
+  for (INT_TYPE k = 0; k < cols.size(); k++)
+    for (INT_TYPE j = k; j < cols.size(); j++) {
+      DATA_TYPE s = k == j ? SCALAR_VAL(-1.0) : SCALAR_VAL(0.0);
+      for (INT_TYPE i = 0; i < m; i++)
+        s += W[cols[k] * m + i] * W[cols[j] * m + i];
+      ortho = fabs(s) > ortho ? fabs(s) : ortho;
+    }
+  polybench_tuned_report("numerical rank %lu, orthogonality error "
+                         "max|Q^T Q - I| = %e\n",
+                         (INT_TYPE)cols.size(), (double)ortho);
+#endif
 #else
   DATA_TYPE nrm;
   polybench_start_instruments;
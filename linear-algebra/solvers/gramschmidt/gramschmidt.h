@@ -49,6 +49,20 @@
 #define _PB_M POLYBENCH_LOOP_BOUND(M, m)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Panel width and row block size of the tuned variant. */
+#ifndef GRAMSCHMIDT_NB
+#define GRAMSCHMIDT_NB 32
+#endif
+#ifndef GRAMSCHMIDT_MB
+#define GRAMSCHMIDT_MB 512
+#endif
+/* Relative norm under which a column is numerically dependent. Such
+   columns are kept out of the projections, and with GRAMSCHMIDT_DEFLATE
+   their Q column is set to zero instead of normalized. */
+#ifndef GRAMSCHMIDT_DEP_TOL
+#define GRAMSCHMIDT_DEP_TOL 1e-10
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
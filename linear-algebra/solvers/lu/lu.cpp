@@ -148,6 +148,89 @@ static void kernel_lu(INT_TYPE n,
   polybench_GPU_array_sync_2D(A, n, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Right-looking blocked LU: panel factorization, triangular solve of the
+     block row, then GEMM update of the trailing matrix. */
+#if defined(POLYBENCH_TUNED_REPORT)
+  double t_panel = 0, t_trsm = 0, t_update = 0;
+#endif
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+#if defined(POLYBENCH_TUNED_REPORT)
+    double t_start = omp_get_wtime();
+#endif
+    for (INT_TYPE kb = 0; kb < n; kb += LU_NB) {
+      const INT_TYPE ke = kb + LU_NB < n ? kb + LU_NB : n;
+
+      for (INT_TYPE k = kb; k < ke; k++) {
+#pragma omp for schedule(static)
+        for (INT_TYPE i = k + 1; i < n; i++) {
+          const DATA_TYPE l = A[i][k] / A[k][k];
+          A[i][k] = l;
+          for (INT_TYPE j = k + 1; j < ke; j++)
+            A[i][j] -= l * A[k][j];
+        }
+      }
+#if defined(POLYBENCH_TUNED_REPORT)
+#pragma omp master
+      {
+        const double t = omp_get_wtime();
+        t_panel += t - t_start;
+        t_start = t;
+      }
+#endif
+
+#pragma omp for schedule(static)
+      for (INT_TYPE jb = ke; jb < n; jb += LU_NB) {
+        const INT_TYPE je = jb + LU_NB < n ? jb + LU_NB : n;
+        for (INT_TYPE k = kb; k < ke; k++)
+          for (INT_TYPE i = k + 1; i < ke; i++) {
+            const DATA_TYPE l = A[i][k];
+#pragma omp simd
+            for (INT_TYPE j = jb; j < je; j++)
+              A[i][j] -= l * A[k][j];
+          }
+      }
+#if defined(POLYBENCH_TUNED_REPORT)
+#pragma omp master
+      {
+        const double t = omp_get_wtime();
+        t_trsm += t - t_start;
+        t_start = t;
+      }
+#endif
+
+#pragma omp for collapse(2) schedule(dynamic)
+      for (INT_TYPE ib = ke; ib < n; ib += LU_NB)
+        for (INT_TYPE jb = ke; jb < n; jb += LU_NB) {
+          const INT_TYPE ie = ib + LU_NB < n ? ib + LU_NB : n;
+          const INT_TYPE je = jb + LU_NB < n ? jb + LU_NB : n;
+          for (INT_TYPE i = ib; i < ie; i++)
+            for (INT_TYPE k = kb; k < ke; k++) {
+              const DATA_TYPE l = A[i][k];
+#pragma omp simd
+              for (INT_TYPE j = jb; j < je; j++)
+                A[i][j] -= l * A[k][j];
+            }
+        }
+#if defined(POLYBENCH_TUNED_REPORT)
+#pragma omp master
+      {
+        const double t = omp_get_wtime();
+        t_update += t - t_start;
+        t_start = t;
+      }
+#endif
+    }
+  }
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report("panel %0.6f s, trsm %0.6f s, update %0.6f s\n",
+                         t_panel, t_trsm, t_update);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
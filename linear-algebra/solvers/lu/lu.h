@@ -43,6 +43,11 @@
 
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Block size of the tuned variant. */
+#ifndef LU_NB
+#define LU_NB 64
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
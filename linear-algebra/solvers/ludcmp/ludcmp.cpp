@@ -72,6 +72,71 @@ static void print_array(INT_TYPE n, ARRAY_1D_FUNC_PARAM(DATA_TYPE, x, N, n)) {
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Right-looking blocked LU (no pivoting, as the reference) of the n x n
+   row-major matrix LU, in place. */
+static void lu_factor_blocked(INT_TYPE n, float *LU) {
+#pragma omp parallel
+  for (INT_TYPE kb = 0; kb < n; kb += LUDCMP_NB) {
+    const INT_TYPE ke = kb + LUDCMP_NB < n ? kb + LUDCMP_NB : n;
+
+    for (INT_TYPE k = kb; k < ke; k++) {
+#pragma omp for schedule(static)
+      for (INT_TYPE i = k + 1; i < n; i++) {
+        const float l = LU[i * n + k] / LU[k * n + k];
+        LU[i * n + k] = l;
+        for (INT_TYPE j = k + 1; j < ke; j++)
+          LU[i * n + j] -= l * LU[k * n + j];
+      }
+    }
+
+#pragma omp for schedule(static)
+    for (INT_TYPE jb = ke; jb < n; jb += LUDCMP_NB) {
+      const INT_TYPE je = jb + LUDCMP_NB < n ? jb + LUDCMP_NB : n;
+      for (INT_TYPE k = kb; k < ke; k++)
+        for (INT_TYPE i = k + 1; i < ke; i++) {
+          const float l = LU[i * n + k];
+#pragma omp simd
+          for (INT_TYPE j = jb; j < je; j++)
+            LU[i * n + j] -= l * LU[k * n + j];
+        }
+    }
+
+#pragma omp for collapse(2) schedule(dynamic)
+    for (INT_TYPE ib = ke; ib < n; ib += LUDCMP_NB)
+      for (INT_TYPE jb = ke; jb < n; jb += LUDCMP_NB) {
+        const INT_TYPE ie = ib + LUDCMP_NB < n ? ib + LUDCMP_NB : n;
+        const INT_TYPE je = jb + LUDCMP_NB < n ? jb + LUDCMP_NB : n;
+        for (INT_TYPE i = ib; i < ie; i++)
+          for (INT_TYPE k = kb; k < ke; k++) {
+            const float l = LU[i * n + k];
+#pragma omp simd
+            for (INT_TYPE j = jb; j < je; j++)
+              LU[i * n + j] -= l * LU[k * n + j];
+          }
+      }
+  }
+}
+
+/* Solve (LU) v = v in place, with the factors of lu_factor_blocked. */
+static void lu_solve(INT_TYPE n, const float *LU, float *v) {
+  for (INT_TYPE i = 0; i < n; i++) {
+    float w = v[i];
+#pragma omp simd reduction(- : w)
+    for (INT_TYPE j = 0; j < i; j++)
+      w -= LU[i * n + j] * v[j];
+    v[i] = w;
+  }
+  for (SINT_TYPE i = n - 1; i >= 0; i--) {
+    float w = v[i];
+#pragma omp simd reduction(- : w)
+    for (INT_TYPE j = i + 1; j < n; j++)
+      w -= LU[i * n + j] * v[j];
+    v[i] = w / LU[i * n + i];
+  }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_ludcmp(INT_TYPE n,
@@ -229,6 +294,64 @@ static void kernel_ludcmp(INT_TYPE n,
   polybench_GPU_array_sync_1D(x, n);
   polybench_GPU_array_sync_1D(y, n);
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Mixed-precision solver: the LU factorization and the substitutions are
+     done in float, the solution is brought back to DATA_TYPE accuracy by
+     iterative refinement on DATA_TYPE residuals. A is left unfactorized
+     since the residuals need it, y holds the last residual. */
+  std::vector<float> LU(n * n);
+  std::vector<float> d(n);
+  INT_TYPE iter = 0;
+  DATA_TYPE berr = 0;
+
+  polybench_start_instruments;
+  DATA_TYPE a_norm = 0, b_norm = 0;
+#pragma omp parallel for reduction(max : a_norm, b_norm)
+  for (INT_TYPE i = 0; i < n; i++) {
+    DATA_TYPE row = 0;
+    for (INT_TYPE j = 0; j < n; j++) {
+      LU[i * n + j] = (float)A[i][j];
+      row += fabs(A[i][j]);
+    }
+    a_norm = row > a_norm ? row : a_norm;
+    b_norm = fabs(b[i]) > b_norm ? fabs(b[i]) : b_norm;
+  }
+
+  lu_factor_blocked(n, LU.data());
+
+  for (INT_TYPE i = 0; i < n; i++)
+    d[i] = (float)b[i];
+  lu_solve(n, LU.data(), d.data());
+  for (INT_TYPE i = 0; i < n; i++)
+    x[i] = d[i];
+
+  for (;;) {
+    DATA_TYPE r_norm = 0, x_norm = 0;
+#pragma omp parallel for reduction(max : r_norm, x_norm)
+    for (INT_TYPE i = 0; i < n; i++) {
+      DATA_TYPE w = b[i];
+#pragma omp simd reduction(- : w)
+      for (INT_TYPE j = 0; j < n; j++)
+        w -= A[i][j] * x[j];
+      y[i] = w;
+      r_norm = fabs(w) > r_norm ? fabs(w) : r_norm;
+      x_norm = fabs(x[i]) > x_norm ? fabs(x[i]) : x_norm;
+    }
+    berr = r_norm / (a_norm * x_norm + b_norm);
+    if (berr <= LUDCMP_REFINE_TOL || iter == LUDCMP_MAX_REFINE)
+      break;
+
+    for (INT_TYPE i = 0; i < n; i++)
+      d[i] = (float)y[i];
+    lu_solve(n, LU.data(), d.data());
+    for (INT_TYPE i = 0; i < n; i++)
+      x[i] += d[i];
+    iter++;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report("%lu refinement steps, backward error %e\n", iter,
+                         (double)berr);
 #else
   polybench_start_instruments;
 #pragma scop
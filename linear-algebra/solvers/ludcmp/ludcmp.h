@@ -43,6 +43,19 @@
 
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Parameters of the tuned (mixed-precision) variant: block size of the
+   float factorization, maximal number of refinement steps and target
+   backward error. */
+#ifndef LUDCMP_NB
+#define LUDCMP_NB 64
+#endif
+#ifndef LUDCMP_MAX_REFINE
+#define LUDCMP_MAX_REFINE 30
+#endif
+#ifndef LUDCMP_REFINE_TOL
+#define LUDCMP_REFINE_TOL 1e-15
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -46,6 +49,44 @@ static void print_array(INT_TYPE n, ARRAY_1D_FUNC_PARAM(DATA_TYPE, x, N, n)) {
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Blocked forward substitution L X = X for nrhs right-hand sides stored
+   one after the other in X (n values each). For each block of TRISOLV_NB
+   rows, the diagonal block is solved, then the solved values are removed
+   from the remaining rows by a parallel GEMV (GEMM for several
+   right-hand sides). Every element of L is read exactly once. */
+static void trisolv_blocked(INT_TYPE n, INT_TYPE nrhs,
+                            ARRAY_2D_FUNC_PARAM(DATA_TYPE, L, N, N, n, n),
+                            DATA_TYPE *X) {
+#pragma omp parallel
+  for (INT_TYPE kb = 0; kb < n; kb += TRISOLV_NB) {
+    const INT_TYPE ke = kb + TRISOLV_NB < n ? kb + TRISOLV_NB : n;
+
+#pragma omp for schedule(static)
+    for (INT_TYPE r = 0; r < nrhs; r++) {
+      DATA_TYPE *xr = &X[r * n];
+      for (INT_TYPE i = kb; i < ke; i++) {
+        DATA_TYPE w = xr[i];
+        for (INT_TYPE j = kb; j < i; j++)
+          w -= L[i][j] * xr[j];
+        xr[i] = w / L[i][i];
+      }
+    }
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = ke; i < n; i++)
+      for (INT_TYPE r = 0; r < nrhs; r++) {
+        const DATA_TYPE *xr = &X[r * n];
+        DATA_TYPE w = SCALAR_VAL(0.0);
+#pragma omp simd reduction(+ : w)
+        for (INT_TYPE j = kb; j < ke; j++)
+          w += L[i][j] * xr[j];
+        X[r * n + i] -= w;
+      }
+  }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_trisolv(INT_TYPE n,
@@ -122,6 +163,18 @@ static void kernel_trisolv(INT_TYPE n,
   polybench_GPU_array_sync_1D(x, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  std::vector<DATA_TYPE> X(TRISOLV_NRHS * n);
+  for (INT_TYPE r = 0; r < TRISOLV_NRHS; r++)
+    for (INT_TYPE i = 0; i < n; i++)
+      X[r * n + i] = b[i] + r;
+
+  polybench_start_instruments;
+  trisolv_blocked(n, TRISOLV_NRHS, L, X.data());
+  polybench_stop_instruments;
+
+  for (INT_TYPE i = 0; i < n; i++)
+    x[i] = X[i];
 #else
   polybench_start_instruments;
 #pragma scop
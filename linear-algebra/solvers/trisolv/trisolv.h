@@ -43,6 +43,16 @@
 
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Block size of the tuned variant and number of right-hand sides solved
+   together with the same L. The extra right-hand sides are shifted copies
+   of b; only the solution of b is printed. */
+#ifndef TRISOLV_NB
+#define TRISOLV_NB 128
+#endif
+#ifndef TRISOLV_NRHS
+#define TRISOLV_NRHS 1
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
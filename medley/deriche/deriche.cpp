@@ -12,6 +12,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
@@ -338,6 +341,96 @@ static void kernel_deriche(INT_TYPE w, INT_TYPE h, DATA_TYPE alpha,
   polybench_GPU_array_sync_2D(y2, w, h);
 
 #endif
+#elif defined(POLYBENCH_TUNED)
+  /* Horizontal passes: each thread takes whole rows. The anti-causal pass
+     runs right after the causal one while the row is in cache, and writes
+     imgOut = c1 * (y1 + y2) directly, so y2 is never stored.
+
+     Vertical passes: the columns are cut into strips of sj adjacent
+     columns, one per SIMD lane, so the recursion along i reads one
+     contiguous segment per row instead of one element. sj is sized so
+     that the y1 and imgOut columns of a strip stay in L2 between the
+     causal and the anti-causal pass. The latter reads the old imgOut
+     value of a row before writing c2 * (y1 + y2) over it. The operations
+     of each pixel are those of the reference, so the result is
+     identical. */
+  const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE) > 0
+                      ? sysconf(_SC_LEVEL2_CACHE_SIZE)
+                      : 256 << 10;
+  INT_TYPE sj = l2 / 2 / (2 * w * sizeof(DATA_TYPE)) / 8 * 8;
+  sj = sj < 8 ? 8 : sj > DERICHE_SJ_MAX ? DERICHE_SJ_MAX : sj;
+  const INT_TYPE nstrips = (h + sj - 1) / sj;
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    std::vector<DATA_TYPE> s1(sj), s2(sj), s3(sj), s4(sj);
+
+#pragma omp for schedule(static)
+    for (INT_TYPE i = 0; i < w; i++) {
+      DATA_TYPE xm1 = SCALAR_VAL(0.0), ym1 = SCALAR_VAL(0.0);
+      DATA_TYPE ym2 = SCALAR_VAL(0.0);
+      for (INT_TYPE j = 0; j < h; j++) {
+        y1[i][j] = a1 * imgIn[i][j] + a2 * xm1 + b1 * ym1 + b2 * ym2;
+        xm1 = imgIn[i][j];
+        ym2 = ym1;
+        ym1 = y1[i][j];
+      }
+      DATA_TYPE xp1 = SCALAR_VAL(0.0), xp2 = SCALAR_VAL(0.0);
+      DATA_TYPE yp1 = SCALAR_VAL(0.0), yp2 = SCALAR_VAL(0.0);
+      for (SINT_TYPE j = h - 1; j >= 0; j--) {
+        const DATA_TYPE y = a3 * xp1 + a4 * xp2 + b1 * yp1 + b2 * yp2;
+        xp2 = xp1;
+        xp1 = imgIn[i][j];
+        yp2 = yp1;
+        yp1 = y;
+        imgOut[i][j] = c1 * (y1[i][j] + y);
+      }
+    }
+
+#pragma omp for schedule(static)
+    for (INT_TYPE s = 0; s < nstrips; s++) {
+      const INT_TYPE j0 = s * sj;
+      const INT_TYPE nj = h - j0 < sj ? h - j0 : sj;
+      DATA_TYPE *tm1 = s1.data(), *ym1 = s2.data(), *ym2 = s3.data();
+      for (INT_TYPE jj = 0; jj < nj; jj++)
+        tm1[jj] = ym1[jj] = ym2[jj] = SCALAR_VAL(0.0);
+      for (INT_TYPE i = 0; i < w; i++) {
+        DATA_TYPE *y1i = &y1[i][j0];
+        const DATA_TYPE *oi = &imgOut[i][j0];
+#pragma omp simd
+        for (INT_TYPE jj = 0; jj < nj; jj++) {
+          y1i[jj] = a5 * oi[jj] + a6 * tm1[jj] + b1 * ym1[jj] + b2 * ym2[jj];
+          tm1[jj] = oi[jj];
+          ym2[jj] = ym1[jj];
+          ym1[jj] = y1i[jj];
+        }
+      }
+
+      DATA_TYPE *tp1 = s1.data(), *tp2 = s2.data();
+      DATA_TYPE *yp1 = s3.data(), *yp2 = s4.data();
+      for (INT_TYPE jj = 0; jj < nj; jj++)
+        tp1[jj] = tp2[jj] = yp1[jj] = yp2[jj] = SCALAR_VAL(0.0);
+      for (SINT_TYPE i = w - 1; i >= 0; i--) {
+        const DATA_TYPE *y1i = &y1[i][j0];
+        DATA_TYPE *oi = &imgOut[i][j0];
+#pragma omp simd
+        for (INT_TYPE jj = 0; jj < nj; jj++) {
+          const DATA_TYPE y = a7 * tp1[jj] + a8 * tp2[jj] + b1 * yp1[jj] +
+                              b2 * yp2[jj];
+          tp2[jj] = tp1[jj];
+          tp1[jj] = oi[jj];
+          yp2[jj] = yp1[jj];
+          yp1[jj] = y;
+          oi[jj] = c2 * (y1i[jj] + y);
+        }
+      }
+    }
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report("vertical strips of %lu columns (%0.2f MB)\n", sj,
+                         2.0 * w * sj * sizeof(DATA_TYPE) / 1e6);
 #else
   DATA_TYPE xm1, tm1, ym1, ym2;
   DATA_TYPE xp1, xp2;
@@ -49,6 +49,11 @@
 #define _PB_W POLYBENCH_LOOP_BOUND(W, w)
 #define _PB_H POLYBENCH_LOOP_BOUND(H, h)
 
+/* Widest column strip of the tuned variant's vertical passes. */
+#ifndef DERICHE_SJ_MAX
+#define DERICHE_SJ_MAX 64
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
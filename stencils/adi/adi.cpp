@@ -12,9 +12,22 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <atomic>
+#include <thread>
+#endif
+#if defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_KOKKOS_GRAPH)
+#include <polybench_graph.h>
+#endif
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <polybench_team.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "adi.h"
@@ -45,6 +58,16 @@ static void print_array(INT_TYPE n,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Spin until a strip has completed at least `sweeps` sweeps. */
+static inline void wait_strip(const std::atomic<INT_TYPE> &done,
+                              INT_TYPE sweeps) {
+  for (INT_TYPE spin = 0; done.load(std::memory_order_acquire) < sweeps; spin++)
+    if (spin > 1024)
+      std::this_thread::yield();
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 /* Based on a Fortran code fragment from Figure 5 of
@@ -127,7 +150,116 @@ static void kernel_adi(INT_TYPE tsteps, INT_TYPE n,
   polybench_stop_instruments;
 
 #elif defined(POLYBENCH_KOKKOS)
-#if not defined(POLYBENCH_GPU) // CPU
+#if not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_PERSISTENT) // CPU
+  /* Persistent mode: one Kokkos team for the whole time loop instead of
+     two parallel_fors per time step. Member tid solves the same systems
+     [i0, i1) in both sweeps of every time step. The column sweep reads
+     every row of u and the row sweep every column of v, so the sweeps
+     are separated by team barriers. */
+  polybench_team team;
+  std::vector<double> wait(Kokkos::OpenMP().concurrency(), 0.0);
+
+  polybench_start_instruments;
+  polybench_team_kokkos(team, [&](const int tid, const int nt) {
+    const INT_TYPE i0 = 1 + (n - 2) * tid / nt;
+    const INT_TYPE i1 = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 1; t <= tsteps; t++) {
+      // Column Sweep
+      for (INT_TYPE i = i0; i < i1; i++) {
+        v(0, i) = SCALAR_VAL(1.0);
+        p(i, 0) = SCALAR_VAL(0.0);
+        q(i, 0) = v(0, i);
+        for (INT_TYPE j = 1; j < n - 1; j++) {
+          p(i, j) = -c / (a * p(i, j - 1) + b);
+          q(i, j) = (-d * u(j, i - 1) +
+                     (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * d) * u(j, i) -
+                     f * u(j, i + 1) - a * q(i, j - 1)) /
+                    (a * p(i, j - 1) + b);
+        }
+        v(n - 1, i) = SCALAR_VAL(1.0);
+        for (INT_TYPE j = n - 2; j >= 1; j--)
+          v(j, i) = p(i, j) * v(j + 1, i) + q(i, j);
+      }
+      polybench_team_sync_all(team, w);
+      // Row Sweep
+      for (INT_TYPE i = i0; i < i1; i++) {
+        u(i, 0) = SCALAR_VAL(1.0);
+        p(i, 0) = SCALAR_VAL(0.0);
+        q(i, 0) = u(i, 0);
+        for (INT_TYPE j = 1; j < n - 1; j++) {
+          p(i, j) = -f / (d * p(i, j - 1) + e);
+          q(i, j) = (-a * v(i - 1, j) +
+                     (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * a) * v(i, j) -
+                     c * v(i + 1, j) - d * q(i, j - 1)) /
+                    (d * p(i, j - 1) + e);
+        }
+        u(i, n - 1) = SCALAR_VAL(1.0);
+        for (INT_TYPE j = n - 2; j >= 1; j--)
+          u(i, j) = p(i, j) * u(i, j + 1) + q(i, j);
+      }
+      polybench_team_sync_all(team, w);
+    }
+    wait[tid] = w;
+  });
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 1);
+#elif not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_GRAPH) // CPU
+  /* Graph replay: the column and row sweeps of a time step are captured
+     once, and the time loop only submits the graph. */
+  polybench_start_instruments;
+  const auto policy_1D = Kokkos::RangePolicy<Kokkos::OpenMP>(1, n - 1);
+  auto graph = Kokkos::Experimental::create_graph(
+      Kokkos::OpenMP(), [&](const auto &root) {
+        // Column Sweep
+        root.then_parallel_for(
+                policy_1D,
+                KOKKOS_LAMBDA(const INT_TYPE i) {
+                  v(0, i) = SCALAR_VAL(1.0);
+                  p(i, 0) = SCALAR_VAL(0.0);
+                  q(i, 0) = v(0, i);
+                  for (INT_TYPE j = 1; j < n - 1; j++) {
+                    p(i, j) = -c / (a * p(i, j - 1) + b);
+                    q(i, j) =
+                        (-d * u(j, i - 1) +
+                         (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * d) * u(j, i) -
+                         f * u(j, i + 1) - a * q(i, j - 1)) /
+                        (a * p(i, j - 1) + b);
+                  }
+
+                  v(n - 1, i) = SCALAR_VAL(1.0);
+                  for (INT_TYPE j = n - 2; j >= 1; j--) {
+                    v(j, i) = p(i, j) * v(j + 1, i) + q(i, j);
+                  }
+                })
+            // Row Sweep
+            .then_parallel_for(
+                policy_1D, KOKKOS_LAMBDA(const INT_TYPE i) {
+                  u(i, 0) = SCALAR_VAL(1.0);
+                  p(i, 0) = SCALAR_VAL(0.0);
+                  q(i, 0) = u(i, 0);
+                  for (INT_TYPE j = 1; j < n - 1; j++) {
+                    p(i, j) = -f / (d * p(i, j - 1) + e);
+                    q(i, j) =
+                        (-a * v(i - 1, j) +
+                         (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * a) * v(i, j) -
+                         c * v(i + 1, j) - d * q(i, j - 1)) /
+                        (d * p(i, j - 1) + e);
+                  }
+                  u(i, n - 1) = SCALAR_VAL(1.0);
+                  for (INT_TYPE j = n - 2; j >= 1; j--) {
+                    u(i, j) = p(i, j) * u(i, j + 1) + q(i, j);
+                  }
+                });
+      });
+  for (INT_TYPE t = 1; t <= tsteps; t++)
+    graph.submit();
+  Kokkos::fence();
+  polybench_stop_instruments;
+
+  polybench_graph_report(policy_1D, policy_1D);
+#elif not defined(POLYBENCH_GPU) // CPU
   polybench_start_instruments;
   const auto policy_1D = Kokkos::RangePolicy<Kokkos::OpenMP>(1, n - 1);
 
@@ -242,6 +374,186 @@ static void kernel_adi(INT_TYPE tsteps, INT_TYPE n,
   polybench_GPU_array_sync_2D(q, n, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_PERSISTENT)
+  /* Persistent mode: one parallel region for the whole time loop. Thread
+     tid solves the same systems [i0, i1) in both sweeps of every time
+     step, with the operations of the reference, so the result is
+     identical. The column sweep reads every row of u and the row sweep
+     every column of v, so the sweeps are separated by team barriers. */
+  const INT_TYPE ns = n > 2 ? n - 2 : 1;
+  const int nt_max = (INT_TYPE)omp_get_max_threads() < ns
+                         ? omp_get_max_threads()
+                         : (int)ns;
+  polybench_team team;
+  std::vector<double> wait(nt_max, 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel num_threads(nt_max)
+  {
+#pragma omp single
+    polybench_team_init(team, omp_get_num_threads());
+    const int nt = team.nthreads, tid = omp_get_thread_num();
+    const INT_TYPE i0 = 1 + (n - 2) * tid / nt;
+    const INT_TYPE i1 = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      // Column Sweep
+      for (INT_TYPE i = i0; i < i1; i++) {
+        v[0][i] = SCALAR_VAL(1.0);
+        p[i][0] = SCALAR_VAL(0.0);
+        q[i][0] = v[0][i];
+        for (INT_TYPE j = 1; j < n - 1; j++) {
+          p[i][j] = -c / (a * p[i][j - 1] + b);
+          q[i][j] = (-d * u[j][i - 1] +
+                     (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * d) * u[j][i] -
+                     f * u[j][i + 1] - a * q[i][j - 1]) /
+                    (a * p[i][j - 1] + b);
+        }
+        v[n - 1][i] = SCALAR_VAL(1.0);
+        for (INT_TYPE j = n - 2; j >= 1; j--)
+          v[j][i] = p[i][j] * v[j + 1][i] + q[i][j];
+      }
+      polybench_team_sync_all(team, w);
+      // Row Sweep
+      for (INT_TYPE i = i0; i < i1; i++) {
+        u[i][0] = SCALAR_VAL(1.0);
+        p[i][0] = SCALAR_VAL(0.0);
+        q[i][0] = u[i][0];
+        for (INT_TYPE j = 1; j < n - 1; j++) {
+          p[i][j] = -f / (d * p[i][j - 1] + e);
+          q[i][j] = (-a * v[i - 1][j] +
+                     (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * a) * v[i][j] -
+                     c * v[i + 1][j] - d * q[i][j - 1]) /
+                    (d * p[i][j - 1] + e);
+        }
+        u[i][n - 1] = SCALAR_VAL(1.0);
+        for (INT_TYPE j = n - 2; j >= 1; j--)
+          u[i][j] = p[i][j] * u[i][j + 1] + q[i][j];
+      }
+      polybench_team_sync_all(team, w);
+    }
+    wait[tid] = w;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 1);
+#elif defined(POLYBENCH_TUNED)
+  /* The systems of each sweep are grouped into strips of ADI_W adjacent
+     systems, one system per SIMD lane, owned cyclically by the threads.
+     p does not depend on the data, so it is computed once per direction.
+
+     - Column sweep: for a fixed j, the systems of a strip read
+       u(j, i - 1 .. i + W) and write v(j, i .. i + W - 1), which are
+       contiguous.
+     - Row sweep: the rows i - 1 .. i + W of v are packed transposed, one
+       j at a time, into a small buffer, and the solution is written back
+       row by row. The recursion is unit-stride here too.
+
+     Step j of the column sweep only needs row j of u, i.e. the row strip
+     that contains j, and step j of the row sweep only needs column j of
+     v. Each strip counts its completed sweeps, and a strip waits on the
+     strip of the other sweep that produced its next j, instead of a
+     global barrier between sweeps. The operations are those of the
+     reference, so the result is identical. */
+  const INT_TYPE W = ADI_W;
+  const INT_TYPE ns = (n - 2 + W - 1) / W;
+  std::vector<std::atomic<INT_TYPE>> col_done(ns), row_done(ns);
+  for (INT_TYPE s = 0; s < ns; s++) {
+    col_done[s].store(0, std::memory_order_relaxed);
+    row_done[s].store(0, std::memory_order_relaxed);
+  }
+  std::vector<DATA_TYPE> pc(n), pr(n);
+  std::vector<double> busy(omp_get_max_threads(), 0.0);
+
+  polybench_start_instruments;
+  pc[0] = pr[0] = SCALAR_VAL(0.0);
+  for (INT_TYPE j = 1; j < n - 1; j++) {
+    pc[j] = -c / (a * pc[j - 1] + b);
+    pr[j] = -f / (d * pr[j - 1] + e);
+  }
+#pragma omp parallel
+  {
+    const INT_TYPE nthreads = omp_get_num_threads();
+    const INT_TYPE tid = omp_get_thread_num();
+    std::vector<DATA_TYPE> Q(n * W), U(n * W);
+    DATA_TYPE vt[ADI_W + 2];
+    double my_busy = 0.0;
+
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      // Column Sweep
+      for (INT_TYPE s = tid; s < ns; s += nthreads) {
+        const INT_TYPE i0 = 1 + s * W;
+        const INT_TYPE w = n - 1 - i0 < W ? n - 1 - i0 : W;
+        double t_busy = omp_get_wtime();
+        for (INT_TYPE k = 0; k < w; k++)
+          Q[k] = SCALAR_VAL(1.0);
+        for (INT_TYPE j = 1; j < n - 1; j++) {
+          if ((j - 1) % W == 0) {
+            my_busy += omp_get_wtime() - t_busy;
+            wait_strip(row_done[(j - 1) / W], t);
+            t_busy = omp_get_wtime();
+          }
+          const DATA_TYPE den = a * pc[j - 1] + b;
+          const DATA_TYPE *uj = &u[j][i0];
+#pragma omp simd
+          for (INT_TYPE k = 0; k < w; k++)
+            Q[j * W + k] = (-d * uj[k - 1] +
+                            (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * d) * uj[k] -
+                            f * uj[k + 1] - a * Q[(j - 1) * W + k]) /
+                           den;
+        }
+        for (INT_TYPE k = 0; k < w; k++)
+          v[0][i0 + k] = v[n - 1][i0 + k] = SCALAR_VAL(1.0);
+        for (INT_TYPE j = n - 2; j >= 1; j--) {
+#pragma omp simd
+          for (INT_TYPE k = 0; k < w; k++)
+            v[j][i0 + k] = pc[j] * v[j + 1][i0 + k] + Q[j * W + k];
+        }
+        col_done[s].store(t + 1, std::memory_order_release);
+        my_busy += omp_get_wtime() - t_busy;
+      }
+      // Row Sweep
+      for (INT_TYPE s = tid; s < ns; s += nthreads) {
+        const INT_TYPE i0 = 1 + s * W;
+        const INT_TYPE w = n - 1 - i0 < W ? n - 1 - i0 : W;
+        double t_busy = omp_get_wtime();
+        for (INT_TYPE k = 0; k < w; k++)
+          Q[k] = U[k] = SCALAR_VAL(1.0);
+        for (INT_TYPE j = 1; j < n - 1; j++) {
+          if ((j - 1) % W == 0) {
+            my_busy += omp_get_wtime() - t_busy;
+            wait_strip(col_done[(j - 1) / W], t + 1);
+            t_busy = omp_get_wtime();
+          }
+          for (INT_TYPE k = 0; k < w + 2; k++)
+            vt[k] = v[i0 - 1 + k][j];
+          const DATA_TYPE den = d * pr[j - 1] + e;
+#pragma omp simd
+          for (INT_TYPE k = 0; k < w; k++)
+            Q[j * W + k] = (-a * vt[k] +
+                            (SCALAR_VAL(1.0) + SCALAR_VAL(2.0) * a) * vt[k + 1] -
+                            c * vt[k + 2] - d * Q[(j - 1) * W + k]) /
+                           den;
+        }
+        for (INT_TYPE k = 0; k < w; k++)
+          U[(n - 1) * W + k] = SCALAR_VAL(1.0);
+        for (INT_TYPE j = n - 2; j >= 1; j--) {
+#pragma omp simd
+          for (INT_TYPE k = 0; k < w; k++)
+            U[j * W + k] = pr[j] * U[(j + 1) * W + k] + Q[j * W + k];
+        }
+        for (INT_TYPE k = 0; k < w; k++)
+          for (INT_TYPE j = 0; j < n; j++)
+            u[i0 + k][j] = U[j * W + k];
+        row_done[s].store(t + 1, std::memory_order_release);
+        my_busy += omp_get_wtime() - t_busy;
+      }
+    }
+    busy[tid] = my_busy;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_busy(busy.data(), (int)busy.size());
 #else
   polybench_start_instruments;
 #pragma scop
@@ -49,6 +49,11 @@
 #define _PB_TSTEPS POLYBENCH_LOOP_BOUND(TSTEPS, tsteps)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Systems solved side by side (one per SIMD lane) by the tuned variant. */
+#ifndef ADI_W
+#define ADI_W 8
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -12,9 +12,25 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_TUNED_MPI) ||      \
+    defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_KOKKOS_GRAPH)
+#include <polybench_graph.h>
+#endif
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <polybench_team.h>
+#endif
+#if defined(POLYBENCH_TUNED_ENGINE)
+#include <polybench_stencil.h>
+#endif
+#if defined(POLYBENCH_TUNED_MPI)
+#include <polybench_mpi.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "fdtd-2d.h"
@@ -75,6 +91,109 @@ static void print_array(INT_TYPE nx, INT_TYPE ny,
   POLYBENCH_DUMP_END("hz");
 }
 
+#if defined(POLYBENCH_TUNED_ENGINE)
+/* fdtd-2d for the stencil engine: one stage per update of the reference,
+   on the fields ex, ey and hz. */
+enum { FDTD_2D_EX, FDTD_2D_EY, FDTD_2D_HZ };
+
+/* ey(0, j) = _fict_(t). */
+struct fdtd_2d_ey0 {
+  static constexpr int dims = 2, radius = 0, field = FDTD_2D_EY;
+  static constexpr unsigned halo = 0;
+  const DATA_TYPE *fict;
+  static void range(const long n[3], long lo[3], long hi[3]) {
+    lo[0] = 0, hi[0] = 1, lo[1] = 0, hi[1] = n[1];
+  }
+  template <class P> DATA_TYPE operator()(const P &, long t) const {
+    return fict[t];
+  }
+};
+
+struct fdtd_2d_ey {
+  static constexpr int dims = 2, radius = 1, field = FDTD_2D_EY;
+  static constexpr unsigned halo = 1u << FDTD_2D_HZ;
+  static constexpr DATA_TYPE w = SCALAR_VAL(0.5);
+  static void range(const long n[3], long lo[3], long hi[3]) {
+    lo[0] = 1, hi[0] = n[0], lo[1] = 0, hi[1] = n[1];
+  }
+  template <class P> DATA_TYPE operator()(const P &p, long) const {
+    return polybench_stencil_at<FDTD_2D_EY>(p, 0, 0) -
+           w * (polybench_stencil_at<FDTD_2D_HZ>(p, 0, 0) -
+                polybench_stencil_at<FDTD_2D_HZ>(p, -1, 0));
+  }
+};
+
+struct fdtd_2d_ex {
+  static constexpr int dims = 2, radius = 0, field = FDTD_2D_EX;
+  static constexpr unsigned halo = 0;
+  static constexpr DATA_TYPE w = SCALAR_VAL(0.5);
+  static void range(const long n[3], long lo[3], long hi[3]) {
+    lo[0] = 0, hi[0] = n[0], lo[1] = 1, hi[1] = n[1];
+  }
+  template <class P> DATA_TYPE operator()(const P &p, long) const {
+    return polybench_stencil_at<FDTD_2D_EX>(p, 0, 0) -
+           w * (polybench_stencil_at<FDTD_2D_HZ>(p, 0, 0) -
+                polybench_stencil_at<FDTD_2D_HZ>(p, 0, -1));
+  }
+};
+
+struct fdtd_2d_hz {
+  static constexpr int dims = 2, radius = 1, field = FDTD_2D_HZ;
+  static constexpr unsigned halo = 1u << FDTD_2D_EY;
+  static constexpr DATA_TYPE w = SCALAR_VAL(0.7);
+  static void range(const long n[3], long lo[3], long hi[3]) {
+    lo[0] = 0, hi[0] = n[0] - 1, lo[1] = 0, hi[1] = n[1] - 1;
+  }
+  template <class P> DATA_TYPE operator()(const P &p, long) const {
+    return polybench_stencil_at<FDTD_2D_HZ>(p, 0, 0) -
+           w * (polybench_stencil_at<FDTD_2D_EX>(p, 0, 1) -
+                polybench_stencil_at<FDTD_2D_EX>(p, 0, 0) +
+                polybench_stencil_at<FDTD_2D_EY>(p, 1, 0) -
+                polybench_stencil_at<FDTD_2D_EY>(p, 0, 0));
+  }
+};
+#endif
+
+#if defined(POLYBENCH_TUNED_MPI)
+/* ey and ex on the block box `b` of the local arrays, with ey(0) set from
+   fict on the first row. */
+static void fdtd_2d_mpi_e(const polybench_mpi_grid &g, DATA_TYPE fict,
+                          DATA_TYPE *ex, DATA_TYPE *ey, const DATA_TYPE *hz,
+                          const polybench_mpi_box &b) {
+  const long ld = g.ln[1];
+  const long j1 = b.lo[1] > 1 ? b.lo[1] : 1;
+#pragma omp parallel for schedule(static)
+  for (long i = b.lo[0]; i < b.hi[0]; i++) {
+    const long r = polybench_mpi_local(g, i, 0);
+    if (i == 0)
+      for (long j = b.lo[1]; j < b.hi[1]; j++)
+        ey[r + j] = fict;
+    else
+#pragma omp simd
+      for (long j = b.lo[1]; j < b.hi[1]; j++)
+        ey[r + j] = ey[r + j] - SCALAR_VAL(0.5) * (hz[r + j] - hz[r + j - ld]);
+#pragma omp simd
+    for (long j = j1; j < b.hi[1]; j++)
+      ex[r + j] = ex[r + j] - SCALAR_VAL(0.5) * (hz[r + j] - hz[r + j - 1]);
+  }
+}
+
+/* hz on the block box `b` of the local arrays. */
+static void fdtd_2d_mpi_h(const polybench_mpi_grid &g, const DATA_TYPE *ex,
+                          const DATA_TYPE *ey, DATA_TYPE *hz,
+                          const polybench_mpi_box &b) {
+  const long ld = g.ln[1];
+#pragma omp parallel for schedule(static)
+  for (long i = b.lo[0]; i < b.hi[0]; i++) {
+    const long r = polybench_mpi_local(g, i, 0);
+#pragma omp simd
+    for (long j = b.lo[1]; j < b.hi[1]; j++)
+      hz[r + j] = hz[r + j] - SCALAR_VAL(0.7) * (ex[r + j + 1] - ex[r + j] +
+                                                 ey[r + j + ld] - ey[r + j]);
+  }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_fdtd_2d(INT_TYPE tmax, INT_TYPE nx, INT_TYPE ny,
@@ -110,7 +229,90 @@ static void kernel_fdtd_2d(INT_TYPE tmax, INT_TYPE nx, INT_TYPE ny,
   polybench_stop_instruments;
 
 #elif defined(POLYBENCH_KOKKOS)
-#if not defined(POLYBENCH_GPU) // CPU
+#if not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_PERSISTENT) // CPU
+  /* Persistent mode: one Kokkos team for the whole time loop instead of
+     four parallel_fors per time step, each member on the same band of
+     rows [i0, i1). Only ey and hz read a row of the neighbouring bands, so
+     two neighbour syncs per time step are enough: after ey, and after ex
+     and hz. */
+  polybench_team team;
+  std::vector<double> wait(Kokkos::OpenMP().concurrency(), 0.0);
+
+  polybench_start_instruments;
+  polybench_team_kokkos(team, [&](const int tid, const int nt) {
+    const INT_TYPE i0 = nx * tid / nt, i1 = nx * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tmax; t++) {
+      if (i0 == 0)
+        for (INT_TYPE j = 0; j < ny; j++)
+          ey(0, j) = _fict_(t);
+      for (INT_TYPE i = i0 > 1 ? i0 : 1; i < i1; i++)
+        for (INT_TYPE j = 0; j < ny; j++)
+          ey(i, j) = ey(i, j) - SCALAR_VAL(0.5) * (hz(i, j) - hz(i - 1, j));
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      for (INT_TYPE i = i0; i < i1; i++)
+        for (INT_TYPE j = 1; j < ny; j++)
+          ex(i, j) = ex(i, j) - SCALAR_VAL(0.5) * (hz(i, j) - hz(i, j - 1));
+      for (INT_TYPE i = i0; i < i1 && i < nx - 1; i++)
+        for (INT_TYPE j = 0; j < ny - 1; j++)
+          hz(i, j) = hz(i, j) - SCALAR_VAL(0.7) * (ex(i, j + 1) - ex(i, j) +
+                                                   ey(i + 1, j) - ey(i, j));
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  });
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tmax, 2, 0);
+#elif not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_GRAPH) // CPU
+  /* Graph replay: the four kernels of a time step are captured once, and
+     the time loop only submits the graph. ey(0), ey and ex are
+     independent, hz waits for all three. The time step is read by the
+     graph from `step`, which is set between two submissions. */
+  polybench_start_instruments;
+
+  const auto policy_1D_y = Kokkos::RangePolicy<Kokkos::OpenMP>(0, ny);
+  const auto policy_2D_1 =
+      Kokkos::MDRangePolicy<Kokkos::OpenMP, Kokkos::Rank<2>>({1, 0}, {nx, ny},
+                                                             {32, 32});
+  const auto policy_2D_2 =
+      Kokkos::MDRangePolicy<Kokkos::OpenMP, Kokkos::Rank<2>>({0, 1}, {nx, ny},
+                                                             {32, 32});
+  const auto policy_2D_3 =
+      Kokkos::MDRangePolicy<Kokkos::OpenMP, Kokkos::Rank<2>>(
+          {0, 0}, {nx - 1, ny - 1}, {32, 32});
+  Kokkos::View<"step", INT_TYPE *, Kokkos::HostSpace> step("step", 1);
+
+  auto graph = Kokkos::Experimental::create_graph(
+      Kokkos::OpenMP(), [&](const auto &root) {
+        auto ey_0 = root.then_parallel_for(
+            policy_1D_y,
+            KOKKOS_LAMBDA(const INT_TYPE j) { ey(0, j) = _fict_(step(0)); });
+        auto ey_i = root.then_parallel_for(
+            policy_2D_1, KOKKOS_LAMBDA(const INT_TYPE i, const INT_TYPE j) {
+              ey(i, j) = ey(i, j) - SCALAR_VAL(0.5) * (hz(i, j) - hz(i - 1, j));
+            });
+        auto ex_j = root.then_parallel_for(
+            policy_2D_2, KOKKOS_LAMBDA(const INT_TYPE i, const INT_TYPE j) {
+              ex(i, j) = ex(i, j) - SCALAR_VAL(0.5) * (hz(i, j) - hz(i, j - 1));
+            });
+        Kokkos::Experimental::when_all(ey_0, ey_i, ex_j)
+            .then_parallel_for(
+                policy_2D_3, KOKKOS_LAMBDA(const INT_TYPE i, const INT_TYPE j) {
+                  hz(i, j) =
+                      hz(i, j) - SCALAR_VAL(0.7) * (ex(i, j + 1) - ex(i, j) +
+                                                    ey(i + 1, j) - ey(i, j));
+                });
+      });
+  for (INT_TYPE t = 0; t < tmax; t++) {
+    step(0) = t;
+    graph.submit();
+    Kokkos::fence();
+  }
+  polybench_stop_instruments;
+
+  polybench_graph_report(policy_1D_y, policy_2D_1, policy_2D_2, policy_2D_3);
+#elif not defined(POLYBENCH_GPU) // CPU
   polybench_start_instruments;
 
   const auto policy_1D_y = Kokkos::RangePolicy<Kokkos::OpenMP>(0, ny);
@@ -207,6 +409,160 @@ static void kernel_fdtd_2d(INT_TYPE tmax, INT_TYPE nx, INT_TYPE ny,
   polybench_GPU_array_sync_2D(hz, nx, ny);
 
 #endif
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_MPI)
+  /* Distributed memory: the fields are split in blocks over a 2-D grid of
+     processes. ey and ex read hz on the low side, hz reads ex and ey on
+     the high side, so each time step exchanges the halos of hz, then
+     those of ex and ey, each overlapped with the interior of the update
+     that reads them. The updates are those of the reference, so the
+     gathered result is identical. */
+  const MPI_Datatype elt = polybench_mpi_type<DATA_TYPE>();
+  const long gn[2] = {(long)nx, (long)ny};
+  const long ld[2] = {(long)(sizeof(ex[0]) / sizeof(ex[0][0])), 1};
+  const polybench_mpi_box e_range = {{0, 0, 0}, {(long)nx, (long)ny, 1}};
+  const polybench_mpi_box h_range = {{0, 0, 0},
+                                     {(long)nx - 1, (long)ny - 1, 1}};
+  polybench_mpi_grid g;
+  polybench_mpi_grid_init(g, 2, gn, elt);
+  std::vector<DATA_TYPE> lex(polybench_mpi_local_size(g)), ley(lex.size()),
+      lhz(lex.size());
+  polybench_mpi_scatter(g, &ex[0][0], ld, lex.data());
+  polybench_mpi_scatter(g, &ey[0][0], ld, ley.data());
+  polybench_mpi_scatter(g, &hz[0][0], ld, lhz.data());
+  DATA_TYPE *pex = lex.data(), *pey = ley.data(), *phz = lhz.data();
+
+  MPI_Barrier(g.comm);
+  polybench_start_instruments;
+  for (INT_TYPE t = 0; t < tmax; t++) {
+    polybench_mpi_sweep(g, {phz}, e_range, [&](const polybench_mpi_box &box) {
+      fdtd_2d_mpi_e(g, _fict_[t], pex, pey, phz, box);
+    });
+    polybench_mpi_sweep(g, {pex, pey}, h_range,
+                        [&](const polybench_mpi_box &box) {
+                          fdtd_2d_mpi_h(g, pex, pey, phz, box);
+                        });
+  }
+  MPI_Barrier(g.comm);
+  polybench_stop_instruments;
+
+  const double t_gather = MPI_Wtime();
+  polybench_mpi_gather(g, pex, &ex[0][0], ld, elt);
+  polybench_mpi_gather(g, pey, &ey[0][0], ld, elt);
+  polybench_mpi_gather(g, phz, &hz[0][0], ld, elt);
+  polybench_mpi_report(g, 3, MPI_Wtime() - t_gather);
+  polybench_mpi_grid_free(g);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_ENGINE)
+  /* Stencil engine: the four stages per time step on static bands of
+     rows. The engine syncs before hz, which reads ey across bands, and
+     before ey(0) of the next step, whose field hz has just read across
+     bands: two neighbour syncs per time step. */
+  const polybench_stencil_shape g = {
+      {(long)nx, (long)ny, 1}, {(long)(sizeof(ex[0]) / sizeof(ex[0][0])), 1}};
+  DATA_TYPE *const f[3] = {&ex[0][0], &ey[0][0], &hz[0][0]};
+  polybench_stencil_sync sync;
+
+  polybench_start_instruments;
+  polybench_stencil_stages(f, g, (long)tmax, sync, fdtd_2d_ey0{&_fict_[0]},
+                           fdtd_2d_ey(), fdtd_2d_ex(), fdtd_2d_hz());
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(sync.wait.data(), sync.nthreads, tmax,
+                              tmax > 0 ? (int)((sync.syncs + tmax - 1) / tmax)
+                                       : 0,
+                              0);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_PERSISTENT)
+  /* Persistent mode: one parallel region for the whole time loop, the
+     sweeps of the reference on the same band of rows [i0, i1) per thread.
+     ey(i0) reads the last hz row of the band above and hz(i1 - 1) the
+     first ey row of the band below, while ex only reads its own rows, so
+     two neighbour syncs per time step are enough: after ey, and after
+     ex and hz. The result is identical. */
+  const int nt_max =
+      (INT_TYPE)omp_get_max_threads() < nx ? omp_get_max_threads() : (int)nx;
+  polybench_team team;
+  std::vector<double> wait(nt_max > 0 ? nt_max : 1, 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel num_threads(nt_max > 0 ? nt_max : 1)
+  {
+#pragma omp single
+    polybench_team_init(team, omp_get_num_threads());
+    const int nt = team.nthreads, tid = omp_get_thread_num();
+    const INT_TYPE i0 = nx * tid / nt, i1 = nx * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tmax; t++) {
+      if (i0 == 0)
+        for (INT_TYPE j = 0; j < ny; j++)
+          ey[0][j] = _fict_[t];
+      for (INT_TYPE i = i0 > 1 ? i0 : 1; i < i1; i++)
+#pragma omp simd
+        for (INT_TYPE j = 0; j < ny; j++)
+          ey[i][j] = ey[i][j] - SCALAR_VAL(0.5) * (hz[i][j] - hz[i - 1][j]);
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      for (INT_TYPE i = i0; i < i1; i++)
+#pragma omp simd
+        for (INT_TYPE j = 1; j < ny; j++)
+          ex[i][j] = ex[i][j] - SCALAR_VAL(0.5) * (hz[i][j] - hz[i][j - 1]);
+      for (INT_TYPE i = i0; i < i1 && i < nx - 1; i++)
+#pragma omp simd
+        for (INT_TYPE j = 0; j < ny - 1; j++)
+          hz[i][j] = hz[i][j] - SCALAR_VAL(0.7) * (ex[i][j + 1] - ex[i][j] +
+                                                   ey[i + 1][j] - ey[i][j]);
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tmax, 2, 0);
+#elif defined(POLYBENCH_TUNED)
+  /* One parallel region for the whole time loop, one fused sweep per time
+     step. Each thread owns a band of rows [i0, i1). Row i of hz needs the
+     new rows i and i + 1 of ey, which in turn need the old rows of hz, so
+     ey is updated one row ahead of hz:
+
+       A. ey(i0) from the old hz (on thread 0, the boundary row ey(0) =
+          _fict_(t)), then a barrier, since ey(i0) reads the last hz row
+          of the band above;
+       B. for i in [i0, i1): ey(i + 1) if i + 1 < i1, ex(i), hz(i), then
+          a barrier.
+
+     Each row of hz is thus read from memory once per time step, and the
+     rows of ex and ey are reused from cache by the next row. The
+     operations are those of the reference, so the result is identical. */
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    const INT_TYPE nt = omp_get_num_threads(), tid = omp_get_thread_num();
+    const INT_TYPE i0 = nx * tid / nt, i1 = nx * (tid + 1) / nt;
+    for (INT_TYPE t = 0; t < tmax; t++) {
+      if (i0 == 0 && i1 > 0)
+        for (INT_TYPE j = 0; j < ny; j++)
+          ey[0][j] = _fict_[t];
+      else if (i0 < i1)
+#pragma omp simd
+        for (INT_TYPE j = 0; j < ny; j++)
+          ey[i0][j] = ey[i0][j] - SCALAR_VAL(0.5) * (hz[i0][j] - hz[i0 - 1][j]);
+#pragma omp barrier
+      for (INT_TYPE i = i0; i < i1; i++) {
+        if (i + 1 < i1)
+#pragma omp simd
+          for (INT_TYPE j = 0; j < ny; j++)
+            ey[i + 1][j] =
+                ey[i + 1][j] - SCALAR_VAL(0.5) * (hz[i + 1][j] - hz[i][j]);
+#pragma omp simd
+        for (INT_TYPE j = 1; j < ny; j++)
+          ex[i][j] = ex[i][j] - SCALAR_VAL(0.5) * (hz[i][j] - hz[i][j - 1]);
+        if (i < nx - 1)
+#pragma omp simd
+          for (INT_TYPE j = 0; j < ny - 1; j++)
+            hz[i][j] = hz[i][j] - SCALAR_VAL(0.7) * (ex[i][j + 1] - ex[i][j] +
+                                                     ey[i + 1][j] - ey[i][j]);
+      }
+#pragma omp barrier
+    }
+  }
+  polybench_stop_instruments;
 #else
   polybench_start_instruments;
 #pragma scop
@@ -12,9 +12,28 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <atomic>
+#include <thread>
+#endif
+#if defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_KOKKOS_GRAPH)
+#include <polybench_graph.h>
+#endif
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <polybench_team.h>
+#endif
+#if defined(POLYBENCH_TUNED_ENGINE)
+#include <polybench_stencil.h>
+#endif
+#if defined(POLYBENCH_TUNED_MPI)
+#include <polybench_mpi.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "heat-3d.h"
@@ -48,6 +67,72 @@ static void print_array(INT_TYPE n,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Spin until a tile column has completed at least `bands` time bands. */
+static inline void wait_column(const std::atomic<INT_TYPE> &done,
+                               INT_TYPE bands) {
+  for (INT_TYPE spin = 0; done.load(std::memory_order_acquire) < bands; spin++)
+    if (spin > 1024)
+      std::this_thread::yield();
+}
+
+/* One half-step on the planes [i0, i1), with flat strides ldi and ldj. */
+static inline void heat_3d_planes(const DATA_TYPE *src, DATA_TYPE *dst,
+                                  INT_TYPE i0, INT_TYPE i1, INT_TYPE n,
+                                  INT_TYPE ldi, INT_TYPE ldj) {
+  for (INT_TYPE i = i0; i < i1; i++)
+    for (INT_TYPE j = 1; j < n - 1; j++) {
+      const DATA_TYPE *c = &src[i * ldi + j * ldj];
+      DATA_TYPE *o = &dst[i * ldi + j * ldj];
+#pragma omp simd
+      for (INT_TYPE k = 1; k < n - 1; k++)
+        o[k] = SCALAR_VAL(0.125) * (c[k + ldi] - SCALAR_VAL(2.0) * c[k] +
+                                    c[k - ldi]) +
+               SCALAR_VAL(0.125) * (c[k + ldj] - SCALAR_VAL(2.0) * c[k] +
+                                    c[k - ldj]) +
+               SCALAR_VAL(0.125) * (c[k + 1] - SCALAR_VAL(2.0) * c[k] + c[k - 1]) +
+               c[k];
+    }
+}
+#endif
+
+#if defined(POLYBENCH_TUNED_ENGINE)
+/* heat-3d for the stencil engine: 7 points, Jacobi, with the expression of
+   the reference. */
+struct heat_3d_stencil {
+  static constexpr int dims = 3, radius = 1;
+  static constexpr polybench_stencil_update update = POLYBENCH_STENCIL_JACOBI;
+  static constexpr DATA_TYPE w = SCALAR_VAL(0.125), c = SCALAR_VAL(2.0);
+  template <class P> DATA_TYPE operator()(const P &a) const {
+    return w * (a(1, 0, 0) - c * a(0, 0, 0) + a(-1, 0, 0)) +
+           w * (a(0, 1, 0) - c * a(0, 0, 0) + a(0, -1, 0)) +
+           w * (a(0, 0, 1) - c * a(0, 0, 0) + a(0, 0, -1)) + a(0, 0, 0);
+  }
+};
+#endif
+
+#if defined(POLYBENCH_TUNED_MPI)
+/* One half-step on the block box `b` of the local arrays. */
+static void heat_3d_mpi_box(const polybench_mpi_grid &g, const DATA_TYPE *src,
+                            DATA_TYPE *dst, const polybench_mpi_box &b) {
+  const long ldi = g.ln[1] * g.ln[2], ldj = g.ln[2];
+#pragma omp parallel for collapse(2) schedule(static)
+  for (long i = b.lo[0]; i < b.hi[0]; i++)
+    for (long j = b.lo[1]; j < b.hi[1]; j++) {
+      const DATA_TYPE *c = &src[polybench_mpi_local(g, i, j, 0)];
+      DATA_TYPE *o = &dst[polybench_mpi_local(g, i, j, 0)];
+#pragma omp simd
+      for (long k = b.lo[2]; k < b.hi[2]; k++)
+        o[k] = SCALAR_VAL(0.125) * (c[k + ldi] - SCALAR_VAL(2.0) * c[k] +
+                                    c[k - ldi]) +
+               SCALAR_VAL(0.125) * (c[k + ldj] - SCALAR_VAL(2.0) * c[k] +
+                                    c[k - ldj]) +
+               SCALAR_VAL(0.125) * (c[k + 1] - SCALAR_VAL(2.0) * c[k] + c[k - 1]) +
+               c[k];
+    }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_heat_3d(INT_TYPE tsteps, INT_TYPE n,
@@ -100,7 +185,104 @@ static void kernel_heat_3d(INT_TYPE tsteps, INT_TYPE n,
       });
   polybench_stop_instruments;
 #elif defined(POLYBENCH_KOKKOS)
-#if not defined(POLYBENCH_GPU) // CPU
+#if not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_PERSISTENT) // CPU
+  /* Persistent mode: one Kokkos team for the whole time loop instead of
+     two parallel_fors per time step. Member tid updates the same block of
+     planes [i0, i1) at every half-step, and only reads the boundary plane
+     of each neighbouring block, so the half-steps are separated by
+     neighbour flags. */
+  polybench_team team;
+  std::vector<double> wait(Kokkos::OpenMP().concurrency(), 0.0);
+
+  polybench_start_instruments;
+  polybench_team_kokkos(team, [&](const int tid, const int nt) {
+    const INT_TYPE i0 = 1 + (n - 2) * tid / nt;
+    const INT_TYPE i1 = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      for (INT_TYPE i = i0; i < i1; i++)
+        for (INT_TYPE j = 1; j < n - 1; j++)
+          for (INT_TYPE k = 1; k < n - 1; k++)
+            B(i, j, k) =
+                SCALAR_VAL(0.125) * (A(i + 1, j, k) -
+                                     SCALAR_VAL(2.0) * A(i, j, k) +
+                                     A(i - 1, j, k)) +
+                SCALAR_VAL(0.125) * (A(i, j + 1, k) -
+                                     SCALAR_VAL(2.0) * A(i, j, k) +
+                                     A(i, j - 1, k)) +
+                SCALAR_VAL(0.125) * (A(i, j, k + 1) -
+                                     SCALAR_VAL(2.0) * A(i, j, k) +
+                                     A(i, j, k - 1)) +
+                A(i, j, k);
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      for (INT_TYPE i = i0; i < i1; i++)
+        for (INT_TYPE j = 1; j < n - 1; j++)
+          for (INT_TYPE k = 1; k < n - 1; k++)
+            A(i, j, k) =
+                SCALAR_VAL(0.125) * (B(i + 1, j, k) -
+                                     SCALAR_VAL(2.0) * B(i, j, k) +
+                                     B(i - 1, j, k)) +
+                SCALAR_VAL(0.125) * (B(i, j + 1, k) -
+                                     SCALAR_VAL(2.0) * B(i, j, k) +
+                                     B(i, j - 1, k)) +
+                SCALAR_VAL(0.125) * (B(i, j, k + 1) -
+                                     SCALAR_VAL(2.0) * B(i, j, k) +
+                                     B(i, j, k - 1)) +
+                B(i, j, k);
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  });
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 0);
+#elif not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_GRAPH) // CPU
+  /* Graph replay: the two half-steps of a time step are captured once,
+     and the time loop only submits the graph. */
+  polybench_start_instruments;
+  const auto policy = Kokkos::MDRangePolicy<Kokkos::OpenMP, Kokkos::Rank<3>>(
+      {1, 1, 1}, {n - 1, n - 1, n - 1}, {32, 32, 32});
+  auto graph = Kokkos::Experimental::create_graph(
+      Kokkos::OpenMP(), [&](const auto &root) {
+        root.then_parallel_for(
+                policy,
+                KOKKOS_LAMBDA(const INT_TYPE i, const INT_TYPE j,
+                              const INT_TYPE k) {
+                  B(i, j, k) =
+                      SCALAR_VAL(0.125) * (A(i + 1, j, k) -
+                                           SCALAR_VAL(2.0) * A(i, j, k) +
+                                           A(i - 1, j, k)) +
+                      SCALAR_VAL(0.125) * (A(i, j + 1, k) -
+                                           SCALAR_VAL(2.0) * A(i, j, k) +
+                                           A(i, j - 1, k)) +
+                      SCALAR_VAL(0.125) * (A(i, j, k + 1) -
+                                           SCALAR_VAL(2.0) * A(i, j, k) +
+                                           A(i, j, k - 1)) +
+                      A(i, j, k);
+                })
+            .then_parallel_for(
+                policy, KOKKOS_LAMBDA(const INT_TYPE i, const INT_TYPE j,
+                                      const INT_TYPE k) {
+                  A(i, j, k) =
+                      SCALAR_VAL(0.125) * (B(i + 1, j, k) -
+                                           SCALAR_VAL(2.0) * B(i, j, k) +
+                                           B(i - 1, j, k)) +
+                      SCALAR_VAL(0.125) * (B(i, j + 1, k) -
+                                           SCALAR_VAL(2.0) * B(i, j, k) +
+                                           B(i, j - 1, k)) +
+                      SCALAR_VAL(0.125) * (B(i, j, k + 1) -
+                                           SCALAR_VAL(2.0) * B(i, j, k) +
+                                           B(i, j, k - 1)) +
+                      B(i, j, k);
+                });
+      });
+  for (INT_TYPE t = 1; t <= tsteps; t++)
+    graph.submit();
+  Kokkos::fence();
+  polybench_stop_instruments;
+
+  polybench_graph_report(policy, policy);
+#elif not defined(POLYBENCH_GPU) // CPU
   polybench_start_instruments;
   const auto policy = Kokkos::MDRangePolicy<Kokkos::OpenMP, Kokkos::Rank<3>>(
       {1, 1, 1}, {n - 1, n - 1, n - 1}, {32, 32, 32});
@@ -187,6 +369,164 @@ static void kernel_heat_3d(INT_TYPE tsteps, INT_TYPE n,
   polybench_GPU_array_sync_3D(B, n, n, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_MPI)
+  /* Distributed memory: the cube is split in blocks over a 3-D grid of
+     processes. Each half-step exchanges the faces of its source while the
+     interior of the block is updated, then updates the rim. The updates
+     are those of the reference, so the gathered result is identical. */
+  const MPI_Datatype elt = polybench_mpi_type<DATA_TYPE>();
+  const long gn[3] = {(long)n, (long)n, (long)n};
+  const long ld[2] = {(long)(sizeof(A[0]) / sizeof(A[0][0][0])),
+                      (long)(sizeof(A[0][0]) / sizeof(A[0][0][0]))};
+  const polybench_mpi_box range = {
+      {1, 1, 1}, {(long)n - 1, (long)n - 1, (long)n - 1}};
+  polybench_mpi_grid g;
+  polybench_mpi_grid_init(g, 3, gn, elt);
+  std::vector<DATA_TYPE> a(polybench_mpi_local_size(g)), b(a.size());
+  polybench_mpi_scatter(g, &A[0][0][0], ld, a.data());
+  polybench_mpi_scatter(g, &B[0][0][0], ld, b.data());
+  DATA_TYPE *pa = a.data(), *pb = b.data();
+
+  MPI_Barrier(g.comm);
+  polybench_start_instruments;
+  for (INT_TYPE t = 1; t <= tsteps; t++) {
+    polybench_mpi_sweep(g, {pa}, range, [&](const polybench_mpi_box &box) {
+      heat_3d_mpi_box(g, pa, pb, box);
+    });
+    polybench_mpi_sweep(g, {pb}, range, [&](const polybench_mpi_box &box) {
+      heat_3d_mpi_box(g, pb, pa, box);
+    });
+  }
+  MPI_Barrier(g.comm);
+  polybench_stop_instruments;
+
+  const double t_gather = MPI_Wtime();
+  polybench_mpi_gather(g, pa, &A[0][0][0], ld, elt);
+  polybench_mpi_report(g, 2, MPI_Wtime() - t_gather);
+  polybench_mpi_grid_free(g);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_ENGINE)
+  /* Stencil engine: 2 * tsteps Jacobi sweeps, in bands of 2 * HEAT_3D_TS
+     sweeps and tiles of HEAT_3D_BI planes. */
+  const long ldi = sizeof(A[0]) / sizeof(A[0][0][0]);
+  const long ldj = sizeof(A[0][0]) / sizeof(A[0][0][0]);
+  const polybench_stencil_shape g = {{(long)n, (long)n, (long)n}, {ldi, ldj}};
+
+  polybench_start_instruments;
+  polybench_stencil_jacobi(heat_3d_stencil(), &A[0][0][0], &B[0][0][0], g,
+                           2 * (long)tsteps, 2 * HEAT_3D_TS, HEAT_3D_BI);
+  polybench_stop_instruments;
+
+  polybench_tuned_report("engine: %d sweeps per band, %d planes per tile\n",
+                         2 * HEAT_3D_TS, HEAT_3D_BI);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_PERSISTENT)
+  /* Persistent mode: one parallel region for the whole time loop, one
+     half-step at a time. Thread tid owns the same block of planes [i0, i1)
+     at every half-step, so its part of A and B stays in its own caches.
+     A block only reads the last plane of the block above and the first
+     plane of the block below, so the half-steps are separated by neighbour
+     flags instead of a fork/join. The result is identical. */
+  const INT_TYPE ldi = sizeof(A[0]) / sizeof(A[0][0][0]);
+  const INT_TYPE ldj = sizeof(A[0][0]) / sizeof(A[0][0][0]);
+  const INT_TYPE np = n > 2 ? n - 2 : 1;
+  const int nt_max = (INT_TYPE)omp_get_max_threads() < np
+                         ? omp_get_max_threads()
+                         : (int)np;
+  polybench_team team;
+  std::vector<double> wait(nt_max, 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel num_threads(nt_max)
+  {
+#pragma omp single
+    polybench_team_init(team, omp_get_num_threads());
+    const int nt = team.nthreads, tid = omp_get_thread_num();
+    const INT_TYPE i0 = 1 + (n - 2) * tid / nt;
+    const INT_TYPE i1 = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      heat_3d_planes(&A[0][0][0], &B[0][0][0], i0, i1, n, ldi, ldj);
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      heat_3d_planes(&B[0][0][0], &A[0][0][0], i0, i1, n, ldi, ldj);
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 0);
+#elif defined(POLYBENCH_TUNED)
+  /* Temporal blocking by time skewing along i. The 2 * tsteps half-steps
+     (A -> B, then B -> A) are grouped into bands of H = 2 * HEAT_3D_TS.
+     Within a band, half-step h updates plane x - h at wavefront x, so the
+     H + 2 planes around the wavefront stay in cache while it advances.
+     Wavefronts are grouped into parallelogram tiles of BI >= H planes.
+
+     Tile (T, I) needs tile (T, I - 1), which the same thread computed just
+     before, and tile (T - 1, I + 1), which is tracked by a per-column band
+     counter. The bands are owned cyclically by the threads and pipelined
+     two tiles apart. Since BI >= H, no tile overwrites a plane that
+     another running tile still reads. Every point is computed from the
+     same values as in the reference, so the result is identical. */
+  const INT_TYPE ldi = sizeof(A[0]) / sizeof(A[0][0][0]);
+  const INT_TYPE ldj = sizeof(A[0][0]) / sizeof(A[0][0][0]);
+  const INT_TYPE H = 2 * HEAT_3D_TS;
+  const INT_TYPE BI = HEAT_3D_BI > H ? HEAT_3D_BI : H;
+  const INT_TYPE nbands = (2 * tsteps + H - 1) / H;
+  const INT_TYPE nbi = (n - 2 + H - 1) / BI + 1;
+  std::vector<std::atomic<INT_TYPE>> done(nbi);
+  for (INT_TYPE b = 0; b < nbi; b++)
+    done[b].store(0, std::memory_order_relaxed);
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    const INT_TYPE nthreads = omp_get_num_threads();
+    for (INT_TYPE T = omp_get_thread_num(); T < nbands; T += nthreads)
+      for (INT_TYPE I = 0; I < nbi; I++) {
+        wait_column(done[I + 1 < nbi ? I + 1 : I], T);
+
+        const INT_TYPE g0 = T * H;
+        const INT_TYPE hb = 2 * tsteps - g0 < H ? 2 * tsteps - g0 : H;
+        for (INT_TYPE x = I * BI; x < (I + 1) * BI; x++)
+          for (INT_TYPE h = 0; h < hb; h++) {
+            if (x < h + 1 || x - h > n - 2)
+              continue;
+            const INT_TYPE i = x - h;
+            const DATA_TYPE *src = (g0 + h) % 2 == 0 ? &A[0][0][0] : &B[0][0][0];
+            DATA_TYPE *dst = (g0 + h) % 2 == 0 ? &B[0][0][0] : &A[0][0][0];
+            for (INT_TYPE j = 1; j < n - 1; j++) {
+              const DATA_TYPE *c = &src[i * ldi + j * ldj];
+              DATA_TYPE *o = &dst[i * ldi + j * ldj];
+#pragma omp simd
+              for (INT_TYPE k = 1; k < n - 1; k++)
+                o[k] = SCALAR_VAL(0.125) * (c[k + ldi] - SCALAR_VAL(2.0) * c[k] +
+                                            c[k - ldi]) +
+                       SCALAR_VAL(0.125) * (c[k + ldj] - SCALAR_VAL(2.0) * c[k] +
+                                            c[k - ldj]) +
+                       SCALAR_VAL(0.125) *
+                           (c[k + 1] - SCALAR_VAL(2.0) * c[k] + c[k - 1]) +
+                       c[k];
+            }
+          }
+
+        done[I].store(T + 1, std::memory_order_release);
+      }
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_heat = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  polybench_tuned_report("%lu half-steps per band, %lu planes per tile, "
+                         "%0.2f GFLOP/s\n",
+                         H, BI,
+                         15.0 * 2 * tsteps * (n - 2) * (n - 2) * (n - 2) /
+                             t_heat * 1e-9);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
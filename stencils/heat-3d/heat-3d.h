@@ -49,6 +49,14 @@
 #define _PB_TSTEPS POLYBENCH_LOOP_BOUND(TSTEPS, tsteps)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Time steps fused per band and planes per tile of the tuned variant. */
+#ifndef HEAT_3D_TS
+#define HEAT_3D_TS 2
+#endif
+#ifndef HEAT_3D_BI
+#define HEAT_3D_BI 8
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -12,9 +12,21 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_KOKKOS_GRAPH)
+#include <polybench_graph.h>
+#endif
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <polybench_team.h>
+#endif
+#if defined(POLYBENCH_TUNED_ENGINE)
+#include <polybench_stencil.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "jacobi-1d.h"
@@ -42,6 +54,28 @@ static void print_array(INT_TYPE n, ARRAY_1D_FUNC_PARAM(DATA_TYPE, A, N, n)) {
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* One half-step on the cells [lo, hi). */
+static inline void jacobi_1d_cells(const DATA_TYPE *src, DATA_TYPE *dst,
+                                   long lo, long hi) {
+#pragma omp simd
+  for (long i = lo; i < hi; i++)
+    dst[i] = 0.33333 * (src[i - 1] + src[i] + src[i + 1]);
+}
+#endif
+
+#if defined(POLYBENCH_TUNED_ENGINE)
+/* jacobi-1d for the stencil engine: 3 taps of weight 1, scaled. */
+struct jacobi_1d_taps {
+  static constexpr int dims = 1, radius = 1;
+  static constexpr polybench_stencil_update update = POLYBENCH_STENCIL_JACOBI;
+  static constexpr polybench_stencil_tap taps[] = {
+      {-1, 0, 0, 1.0}, {0, 0, 0, 1.0}, {1, 0, 0, 1.0}};
+  static constexpr double scale = 0.33333;
+};
+typedef polybench_stencil_linear<DATA_TYPE, jacobi_1d_taps> jacobi_1d_stencil;
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_jacobi_1d(INT_TYPE tsteps, INT_TYPE n,
@@ -64,7 +98,57 @@ static void kernel_jacobi_1d(INT_TYPE tsteps, INT_TYPE n,
       });
   polybench_stop_instruments;
 #elif defined(POLYBENCH_KOKKOS)
-#if not defined(POLYBENCH_GPU) // CPU
+#if not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_PERSISTENT) // CPU
+  /* Persistent mode: one Kokkos team for the whole time loop instead of
+     two parallel_fors per time step. Member tid updates the same block of
+     cells [lo, hi) at every half-step, and only reads one cell of each
+     neighbouring block, so the half-steps are separated by neighbour
+     flags. */
+  polybench_team team;
+  std::vector<double> wait(Kokkos::OpenMP().concurrency(), 0.0);
+
+  polybench_start_instruments;
+  polybench_team_kokkos(team, [&](const int tid, const int nt) {
+    const INT_TYPE lo = 1 + (n - 2) * tid / nt;
+    const INT_TYPE hi = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      for (INT_TYPE i = lo; i < hi; i++)
+        B(i) = SCALAR_VAL(0.33333) * (A(i - 1) + A(i) + A(i + 1));
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      for (INT_TYPE i = lo; i < hi; i++)
+        A(i) = SCALAR_VAL(0.33333) * (B(i - 1) + B(i) + B(i + 1));
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  });
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 0);
+#elif not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_GRAPH) // CPU
+  /* Graph replay: the two sweeps of a time step are captured once, and
+     the time loop only submits the graph. */
+  polybench_start_instruments;
+  const auto policy = Kokkos::RangePolicy<Kokkos::OpenMP>(1, n - 1);
+  auto graph = Kokkos::Experimental::create_graph(
+      Kokkos::OpenMP(), [&](const auto &root) {
+        root.then_parallel_for(
+                policy,
+                KOKKOS_LAMBDA(const INT_TYPE i) {
+                  B(i) = SCALAR_VAL(0.33333) * (A(i - 1) + A(i) + A(i + 1));
+                })
+            .then_parallel_for(
+                policy, KOKKOS_LAMBDA(const INT_TYPE i) {
+                  A(i) = SCALAR_VAL(0.33333) * (B(i - 1) + B(i) + B(i + 1));
+                });
+      });
+  for (INT_TYPE t = 0; t < tsteps; t++)
+    graph.submit();
+  Kokkos::fence();
+  polybench_stop_instruments;
+
+  polybench_graph_report(policy, policy);
+#elif not defined(POLYBENCH_GPU) // CPU
   polybench_start_instruments;
   const auto policy = Kokkos::RangePolicy<Kokkos::OpenMP>(1, n - 1);
   for (INT_TYPE t = 0; t < tsteps; t++) {
@@ -109,6 +193,138 @@ static void kernel_jacobi_1d(INT_TYPE tsteps, INT_TYPE n,
   polybench_GPU_array_sync_1D(B, n);
 
 #endif
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_ENGINE)
+  /* Stencil engine: 2 * tsteps Jacobi sweeps, in bands of 2 * JACOBI_1D_TS
+     sweeps and tiles of JACOBI_1D_BS cells. */
+  const polybench_stencil_shape g = {{(long)n, 1, 1}, {1, 0}};
+
+  polybench_start_instruments;
+  polybench_stencil_jacobi(jacobi_1d_stencil(), &A[0], &B[0], g,
+                           2 * (long)tsteps, 2 * JACOBI_1D_TS, JACOBI_1D_BS);
+  polybench_stop_instruments;
+
+  polybench_tuned_report("engine: %d sweeps per band, %d cells per tile\n",
+                         2 * JACOBI_1D_TS, JACOBI_1D_BS);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_PERSISTENT)
+  /* Persistent mode: one parallel region for the whole time loop, one
+     sweep at a time on the same block of cells [lo, hi) per thread. A
+     block only reads one cell of each neighbouring block, so the sweeps
+     are separated by neighbour flags. Unlike the variant below, there is
+     no temporal blocking: one sync per half-step. The result is
+     identical. */
+  const long nn = n, nc = nn > 2 ? nn - 2 : 1;
+  const int nt_max =
+      omp_get_max_threads() < nc ? omp_get_max_threads() : (int)nc;
+  DATA_TYPE *a = &A[0], *b = &B[0];
+  polybench_team team;
+  std::vector<double> wait(nt_max, 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel num_threads(nt_max)
+  {
+#pragma omp single
+    polybench_team_init(team, omp_get_num_threads());
+    const int nt = team.nthreads, tid = omp_get_thread_num();
+    const long lo = 1 + (nn - 2) * tid / nt;
+    const long hi = 1 + (nn - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (long t = 0; t < (long)tsteps; t++) {
+      jacobi_1d_cells(a, b, lo, hi);
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      jacobi_1d_cells(b, a, lo, hi);
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 0);
+#elif defined(POLYBENCH_TUNED)
+  /* A single parallel region for the whole time loop. Each thread owns a
+     fixed block of the domain and advances it by bands of H half-steps
+     (H = 2 * JACOBI_1D_TS, capped to half of the smallest block):
+
+     1. At half-step h of the band, every block updates its cells minus h
+        on each side that borders another block, i.e. a shrinking
+        trapezoid that needs no data from the neighbours. The trapezoid
+        is swept in skewed chunks of JACOBI_1D_BS cells, so the H
+        half-steps of a chunk run out of L1.
+     2. After a barrier, the thread on the left of each inner boundary
+        fills the triangle [hi - h, hi + h) that the two trapezoids left
+        out, then all threads meet at a second barrier.
+
+     That is two barriers per H half-steps instead of two fork/joins per
+     time step. Every cell is computed from the same values as in the
+     reference, so the result is identical. */
+  const long nn = n, S = 2 * tsteps;
+  DATA_TYPE *a = &A[0], *b = &B[0];
+#if defined(POLYBENCH_TUNED_REPORT)
+  /* Initial arrays, for the comparison run below. */
+  std::vector<DATA_TYPE> a_ref(a, a + nn), b_ref(b, b + nn);
+#endif
+
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  {
+    const long nt = omp_get_num_threads(), tid = omp_get_thread_num();
+    const long lo = 1 + (nn - 2) * tid / nt;
+    const long hi = 1 + (nn - 2) * (tid + 1) / nt;
+    const long sl = lo > 1, sr = hi < nn - 1;
+    long H = 2 * JACOBI_1D_TS;
+    H = 2 * H > (nn - 2) / nt ? (nn - 2) / nt / 2 : H;
+    H = H < 1 ? 1 : H;
+
+    for (long s0 = 0; s0 < S; s0 += H) {
+      const long hb = S - s0 < H ? S - s0 : H;
+      for (long c = lo; c - (hb - 1) < hi; c += JACOBI_1D_BS)
+        for (long h = 0; h < hb; h++) {
+          const long x0 = c - h > lo + sl * h ? c - h : lo + sl * h;
+          const long x1 = c + JACOBI_1D_BS - h < hi - sr * h
+                              ? c + JACOBI_1D_BS - h
+                              : hi - sr * h;
+          if ((s0 + h) % 2 == 0)
+            jacobi_1d_cells(a, b, x0, x1);
+          else
+            jacobi_1d_cells(b, a, x0, x1);
+        }
+#pragma omp barrier
+      if (sr)
+        for (long h = 1; h < hb; h++) {
+          if ((s0 + h) % 2 == 0)
+            jacobi_1d_cells(a, b, hi - h, hi + h);
+          else
+            jacobi_1d_cells(b, a, hi - h, hi + h);
+        }
+#pragma omp barrier
+    }
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_jacobi = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  /* The current version for comparison, one fork/join per sweep, on
+     copies of the initial arrays. */
+  const double t_ref_start = omp_get_wtime();
+  for (INT_TYPE t = 0; t < tsteps; t++) {
+#pragma omp parallel for schedule(static)
+    for (long i = 1; i < nn - 1; i++)
+      b_ref[i] = 0.33333 * (a_ref[i - 1] + a_ref[i] + a_ref[i + 1]);
+#pragma omp parallel for schedule(static)
+    for (long i = 1; i < nn - 1; i++)
+      a_ref[i] = 0.33333 * (b_ref[i - 1] + b_ref[i] + b_ref[i + 1]);
+  }
+  const double t_ref = omp_get_wtime() - t_ref_start;
+  const double updates = 2.0 * tsteps * (nn - 2);
+  polybench_tuned_report("%0.1f Mupdates/s, fork/join per sweep %0.1f "
+                         "Mupdates/s (%0.2fx)\n",
+                         updates / t_jacobi * 1e-6, updates / t_ref * 1e-6,
+                         t_ref / t_jacobi);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
@@ -49,6 +49,14 @@
 #define _PB_TSTEPS POLYBENCH_LOOP_BOUND(TSTEPS, tsteps)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Time steps per band and cells per chunk of the tuned variant. */
+#ifndef JACOBI_1D_TS
+#define JACOBI_1D_TS 16
+#endif
+#ifndef JACOBI_1D_BS
+#define JACOBI_1D_BS 512
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
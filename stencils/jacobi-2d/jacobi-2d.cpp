@@ -12,9 +12,22 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_TUNED_MPI) ||      \
+    defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED_PERSISTENT) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <polybench_team.h>
+#endif
+#if defined(POLYBENCH_TUNED_ENGINE)
+#include <polybench_stencil.h>
+#endif
+#if defined(POLYBENCH_TUNED_MPI)
+#include <polybench_mpi.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "jacobi-2d.h"
@@ -47,6 +60,40 @@ static void print_array(INT_TYPE n,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED_ENGINE)
+/* jacobi-2d for the stencil engine: 5 taps of weight 1, scaled, in the
+   order of the reference. */
+struct jacobi_2d_taps {
+  static constexpr int dims = 2, radius = 1;
+  static constexpr polybench_stencil_update update = POLYBENCH_STENCIL_JACOBI;
+  static constexpr polybench_stencil_tap taps[] = {{0, 0, 0, 1.0},
+                                                   {0, -1, 0, 1.0},
+                                                   {0, 1, 0, 1.0},
+                                                   {1, 0, 0, 1.0},
+                                                   {-1, 0, 0, 1.0}};
+  static constexpr double scale = 0.2;
+};
+typedef polybench_stencil_linear<DATA_TYPE, jacobi_2d_taps> jacobi_2d_stencil;
+#endif
+
+#if defined(POLYBENCH_TUNED_MPI)
+/* One half time step on the block box `b` of the local arrays. */
+static void jacobi_2d_mpi_box(const polybench_mpi_grid &g,
+                              const DATA_TYPE *src, DATA_TYPE *dst,
+                              const polybench_mpi_box &b) {
+  const long ld = g.ln[1];
+#pragma omp parallel for schedule(static)
+  for (long i = b.lo[0]; i < b.hi[0]; i++) {
+    const DATA_TYPE *r = &src[polybench_mpi_local(g, i, 0)];
+    DATA_TYPE *o = &dst[polybench_mpi_local(g, i, 0)];
+#pragma omp simd
+    for (long j = b.lo[1]; j < b.hi[1]; j++)
+      o[j] = SCALAR_VAL(0.2) *
+             (r[j] + r[j - 1] + r[1 + j] + r[j + ld] + r[j - ld]);
+  }
+}
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_jacobi_2d(INT_TYPE tsteps, INT_TYPE n,
@@ -73,7 +120,38 @@ static void kernel_jacobi_2d(INT_TYPE tsteps, INT_TYPE n,
       });
   polybench_stop_instruments;
 #elif defined(POLYBENCH_KOKKOS)
-#if not defined(POLYBENCH_GPU) // CPU
+#if not defined(POLYBENCH_GPU) && defined(POLYBENCH_KOKKOS_PERSISTENT) // CPU
+  /* Persistent mode: one Kokkos team for the whole time loop instead of
+     two parallel_fors per time step. Member tid updates the same block of
+     rows [i0, i1) at every half-step, and only reads the boundary row of
+     each neighbouring block, so the half-steps are separated by neighbour
+     flags. */
+  polybench_team team;
+  std::vector<double> wait(Kokkos::OpenMP().concurrency(), 0.0);
+
+  polybench_start_instruments;
+  polybench_team_kokkos(team, [&](const int tid, const int nt) {
+    const INT_TYPE i0 = 1 + (n - 2) * tid / nt;
+    const INT_TYPE i1 = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      for (INT_TYPE i = i0; i < i1; i++)
+        for (INT_TYPE j = 1; j < n - 1; j++)
+          B(i, j) = SCALAR_VAL(0.2) * (A(i, j) + A(i, j - 1) + A(i, 1 + j) +
+                                       A(1 + i, j) + A(i - 1, j));
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      for (INT_TYPE i = i0; i < i1; i++)
+        for (INT_TYPE j = 1; j < n - 1; j++)
+          A(i, j) = SCALAR_VAL(0.2) * (B(i, j) + B(i, j - 1) + B(i, 1 + j) +
+                                       B(1 + i, j) + B(i - 1, j));
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  });
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 0);
+#elif not defined(POLYBENCH_GPU) // CPU
   polybench_start_instruments;
   const auto policy = Kokkos::MDRangePolicy<Kokkos::OpenMP, Kokkos::Rank<2>>(
       {1, 1}, {n - 1, n - 1}, {32, 32});
@@ -125,6 +203,189 @@ static void kernel_jacobi_2d(INT_TYPE tsteps, INT_TYPE n,
   polybench_GPU_array_sync_2D(A, n, n);
   polybench_GPU_array_sync_2D(B, n, n);
 #endif
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_MPI)
+  /* Distributed memory: the grid is split in blocks over a 2-D grid of
+     processes. Each half step exchanges the halos of its source while the
+     interior of the block is updated, then updates the rim. The updates
+     are those of the reference, so the gathered result is identical. */
+  const MPI_Datatype elt = polybench_mpi_type<DATA_TYPE>();
+  const long gn[2] = {(long)n, (long)n};
+  const long ld[2] = {(long)(sizeof(A[0]) / sizeof(A[0][0])), 1};
+  const polybench_mpi_box range = {{1, 1, 0}, {(long)n - 1, (long)n - 1, 1}};
+  polybench_mpi_grid g;
+  polybench_mpi_grid_init(g, 2, gn, elt);
+  std::vector<DATA_TYPE> a(polybench_mpi_local_size(g)), b(a.size());
+  polybench_mpi_scatter(g, &A[0][0], ld, a.data());
+  polybench_mpi_scatter(g, &B[0][0], ld, b.data());
+  DATA_TYPE *pa = a.data(), *pb = b.data();
+
+  MPI_Barrier(g.comm);
+  polybench_start_instruments;
+  for (INT_TYPE t = 0; t < tsteps; t++) {
+    polybench_mpi_sweep(g, {pa}, range, [&](const polybench_mpi_box &box) {
+      jacobi_2d_mpi_box(g, pa, pb, box);
+    });
+    polybench_mpi_sweep(g, {pb}, range, [&](const polybench_mpi_box &box) {
+      jacobi_2d_mpi_box(g, pb, pa, box);
+    });
+  }
+  MPI_Barrier(g.comm);
+  polybench_stop_instruments;
+
+  const double t_gather = MPI_Wtime();
+  polybench_mpi_gather(g, pa, &A[0][0], ld, elt);
+  polybench_mpi_report(g, 2, MPI_Wtime() - t_gather);
+  polybench_mpi_grid_free(g);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_ENGINE)
+  /* Stencil engine: 2 * tsteps Jacobi sweeps, in bands of 2 * JACOBI_2D_TS
+     sweeps and tiles of JACOBI_2D_BI rows. */
+  const polybench_stencil_shape g = {
+      {(long)n, (long)n, 1}, {(long)(sizeof(A[0]) / sizeof(A[0][0])), 1}};
+
+  polybench_start_instruments;
+  polybench_stencil_jacobi(jacobi_2d_stencil(), &A[0][0], &B[0][0], g,
+                           2 * (long)tsteps, 2 * JACOBI_2D_TS, JACOBI_2D_BI);
+  polybench_stop_instruments;
+
+  polybench_tuned_report("engine: %d sweeps per band, %d rows per tile\n",
+                         2 * JACOBI_2D_TS, JACOBI_2D_BI);
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_PERSISTENT)
+  /* Persistent mode: one parallel region for the whole time loop, one
+     sweep at a time. Thread tid owns the same block of rows [i0, i1) in
+     every sweep, and only reads one row of each neighbouring block, so
+     the sweeps are separated by neighbour flags instead of a fork/join.
+     The result is identical. */
+  const INT_TYPE nr = n > 2 ? n - 2 : 1;
+  const int nt_max = (INT_TYPE)omp_get_max_threads() < nr
+                         ? omp_get_max_threads()
+                         : (int)nr;
+  polybench_team team;
+  std::vector<double> wait(nt_max, 0.0);
+
+  polybench_start_instruments;
+#pragma omp parallel num_threads(nt_max)
+  {
+#pragma omp single
+    polybench_team_init(team, omp_get_num_threads());
+    const int nt = team.nthreads, tid = omp_get_thread_num();
+    const INT_TYPE i0 = 1 + (n - 2) * tid / nt;
+    const INT_TYPE i1 = 1 + (n - 2) * (tid + 1) / nt;
+    double w = 0.0;
+    for (INT_TYPE t = 0; t < tsteps; t++) {
+      for (INT_TYPE i = i0; i < i1; i++)
+#pragma omp simd
+        for (INT_TYPE j = 1; j < n - 1; j++)
+          B[i][j] = SCALAR_VAL(0.2) * (A[i][j] + A[i][j - 1] + A[i][1 + j] +
+                                       A[1 + i][j] + A[i - 1][j]);
+      polybench_team_sync(team, tid, 2 * t + 1, w);
+      for (INT_TYPE i = i0; i < i1; i++)
+#pragma omp simd
+        for (INT_TYPE j = 1; j < n - 1; j++)
+          A[i][j] = SCALAR_VAL(0.2) * (B[i][j] + B[i][j - 1] + B[i][1 + j] +
+                                       B[1 + i][j] + B[i - 1][j]);
+      polybench_team_sync(team, tid, 2 * t + 2, w);
+    }
+    wait[tid] = w;
+  }
+  polybench_stop_instruments;
+
+  polybench_tuned_report_sync(wait.data(), team.nthreads, tsteps, 2, 0);
+#elif defined(POLYBENCH_TUNED)
+  /* Diamond tiling of the (half-step, i) space. Half-step s computes B
+     from A when s is even and A from B when s is odd. In the rotated
+     coordinates u = s + i and v = s - i + n, every dependence has a
+     non-negative distance, so tiling both by JACOBI_2D_D gives diamonds
+     in (s, i). Tile (U, V) only needs tiles of lower U + V. The diamonds
+     of one level U + V cover all rows at once (concurrent start) and are
+     handed out dynamically.
+
+     Inside a diamond, the columns are swept as a wavefront: half-step h
+     of the tile updates columns [c - h, c + BJ - h) at wavefront c. Only
+     D rows by BJ + D columns of A and B are live, and BJ is sized to L2.
+     A point is only overwritten after all of its readers have run, since
+     these readers are exactly its flow predecessors. The result is thus
+     identical to the reference. */
+  const long D = JACOBI_2D_D;
+  const long S = 2 * tsteps, nn = n;
+  const INT_TYPE lda = sizeof(A[0]) / sizeof(A[0][0]);
+  const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE) > 0
+                      ? sysconf(_SC_LEVEL2_CACHE_SIZE)
+                      : 256 << 10;
+  long BJ = l2 / 2 / (2 * D * sizeof(DATA_TYPE)) - D;
+  BJ = BJ < 64 ? 64 : BJ;
+  const long nu = (S + nn - 3) / D + 1;
+  const long nv = (S + nn - 2) / D + 1;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  const int llc = polybench_tuned_llc_start();
+#endif
+  polybench_start_instruments;
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#pragma omp parallel
+  for (long W = 0; W < nu + nv - 1; W++) {
+    const long U0 = W - nv + 1 > 0 ? W - nv + 1 : 0;
+    const long U1 = W + 1 < nu ? W + 1 : nu;
+#pragma omp for schedule(dynamic)
+    for (long U = U0; U < U1; U++) {
+      const long V = W - U;
+      const long u0 = U * D, w0 = V * D;
+      long s0 = u0 + w0 - nn + 1 > 0 ? (u0 + w0 - nn + 1) / 2 : 0;
+      long s1 = (u0 + w0 + 2 * D - 2 - nn) / 2;
+      s1 = s1 < S - 1 ? s1 : S - 1;
+      for (long c = 1; c - (s1 - s0) < nn - 1; c += BJ)
+        for (long s = s0; s <= s1; s++) {
+          long i0 = u0 - s > s + nn - w0 - D + 1 ? u0 - s : s + nn - w0 - D + 1;
+          long i1 = u0 + D - 1 - s < s + nn - w0 ? u0 + D - 1 - s : s + nn - w0;
+          long j0 = c - (s - s0), j1 = j0 + BJ;
+          i0 = i0 < 1 ? 1 : i0;
+          i1 = i1 > nn - 2 ? nn - 2 : i1;
+          j0 = j0 < 1 ? 1 : j0;
+          j1 = j1 > nn - 1 ? nn - 1 : j1;
+          const DATA_TYPE *src = s % 2 == 0 ? &A[0][0] : &B[0][0];
+          DATA_TYPE *dst = s % 2 == 0 ? &B[0][0] : &A[0][0];
+          for (long i = i0; i <= i1; i++) {
+            const DATA_TYPE *r = &src[i * lda];
+            DATA_TYPE *o = &dst[i * lda];
+#pragma omp simd
+            for (long j = j0; j < j1; j++)
+              o[j] = SCALAR_VAL(0.2) * (r[j] + r[j - 1] + r[1 + j] +
+                                        r[j + lda] + r[j - lda]);
+          }
+        }
+    }
+  }
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_jacobi = omp_get_wtime() - t_start;
+#endif
+  polybench_stop_instruments;
+
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double traffic = polybench_tuned_llc_stop(llc);
+
+  /* Each half-step of the reference streams one grid in and one out. */
+  const double ref_traffic = 2.0 * S * nn * nn * sizeof(DATA_TYPE);
+  const double bw = polybench_tuned_stream_bandwidth();
+  polybench_tuned_report("diamond %ld half-steps, column block %ld, %0.2f "
+                         "GFLOP/s\n",
+                         D, BJ,
+                         5.0 * S * (nn - 2) * (nn - 2) / t_jacobi * 1e-9);
+  if (traffic >= 0.0)
+    polybench_tuned_report("memory traffic %0.2f GB measured, %0.2f GB for "
+                           "the streaming reference (%0.1fx less)\n",
+                           traffic * 1e-9, ref_traffic * 1e-9,
+                           ref_traffic / (traffic > 0.0 ? traffic : 1.0));
+  else
+    polybench_tuned_report("memory traffic not measured (no access to the "
+                           "LLC counter), %0.2f GB for the streaming "
+                           "reference\n",
+                           ref_traffic * 1e-9);
+  polybench_tuned_report("reference traffic at %0.2f GB/s takes %0.4f s, "
+                         "%0.2fx the tuned time\n",
+                         bw * 1e-9, ref_traffic / bw,
+                         ref_traffic / bw / t_jacobi);
+#endif
 #else
   polybench_start_instruments;
 #pragma scop
@@ -49,6 +49,19 @@
 #define _PB_TSTEPS POLYBENCH_LOOP_BOUND(TSTEPS, tsteps)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Diamond size, in half-steps, of the tuned variant. */
+#ifndef JACOBI_2D_D
+#define JACOBI_2D_D 32
+#endif
+
+/* Time steps fused per band and rows per tile of the engine variant. */
+#ifndef JACOBI_2D_TS
+#define JACOBI_2D_TS 2
+#endif
+#ifndef JACOBI_2D_BI
+#define JACOBI_2D_BI 16
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
@@ -12,9 +12,17 @@
 #include <math.h>
 #include <stdio.h>
 #include <unistd.h>
+#if defined(POLYBENCH_TUNED)
+#include <atomic>
+#include <thread>
+#include <vector>
+#endif
 
 /* Include polybench common header. */
 #include <polybench.h>
+#if defined(POLYBENCH_TUNED_ENGINE)
+#include <polybench_stencil.h>
+#endif
 
 /* Include benchmark-specific header. */
 #include "seidel-2d.h"
@@ -24,7 +32,13 @@ static void init_array(INT_TYPE n,
                        ARRAY_2D_FUNC_PARAM(DATA_TYPE, A, N, N, n, n)) {
   for (INT_TYPE i = 0; i < n; i++)
     for (INT_TYPE j = 0; j < n; j++)
+#if defined(SEIDEL_INIT_NONLINEAR)
+      /* For validation: the default init is bilinear and thus a fixed point
+         of the 9-point average, which hides update-order errors. */
+      ARRAY_2D_ACCESS(A, i, j) = (DATA_TYPE)((i * i * (j + 3) + j * j) % n) / n;
+#else
       ARRAY_2D_ACCESS(A, i, j) = ((DATA_TYPE)i * (j + 2) + 2) / n;
+#endif
 }
 
 /* DCE code. Must scan the entire live-out data.
@@ -44,6 +58,32 @@ static void print_array(INT_TYPE n,
   POLYBENCH_DUMP_FINISH;
 }
 
+#if defined(POLYBENCH_TUNED)
+/* Spin until a tile has completed at least `steps` time steps. */
+static inline void wait_tile(const std::atomic<INT_TYPE> &done,
+                             INT_TYPE steps) {
+  for (INT_TYPE spin = 0; done.load(std::memory_order_acquire) < steps; spin++)
+    if (spin > 1024)
+      std::this_thread::yield();
+}
+#endif
+
+#if defined(POLYBENCH_TUNED_ENGINE)
+/* seidel-2d for the stencil engine: 9 points, Gauss-Seidel, with the
+   expression of the reference. */
+struct seidel_2d_stencil {
+  static constexpr int dims = 2, radius = 1;
+  static constexpr polybench_stencil_update update =
+      POLYBENCH_STENCIL_GAUSS_SEIDEL;
+  static constexpr DATA_TYPE div = SCALAR_VAL(9.0);
+  template <class P> DATA_TYPE operator()(const P &a) const {
+    return (a(-1, -1) + a(-1, 0) + a(-1, 1) + a(0, -1) + a(0, 0) + a(0, 1) +
+            a(1, -1) + a(1, 0) + a(1, 1)) /
+           div;
+  }
+};
+#endif
+
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static void kernel_seidel_2d(INT_TYPE tsteps, INT_TYPE n,
@@ -113,6 +153,72 @@ static void kernel_seidel_2d(INT_TYPE tsteps, INT_TYPE n,
 
   polybench_GPU_array_sync_2D(A, n, n);
 #endif
+#elif defined(POLYBENCH_TUNED) && defined(POLYBENCH_TUNED_ENGINE)
+  /* Stencil engine: tsteps Gauss-Seidel sweeps, pipelined over bands of
+     SEIDEL_TI rows. */
+  const polybench_stencil_shape g = {
+      {(long)n, (long)n, 1}, {(long)(sizeof(A[0]) / sizeof(A[0][0])), 1}};
+
+  polybench_start_instruments;
+  polybench_stencil_gauss_seidel(seidel_2d_stencil(), &A[0][0], g,
+                                 (long)tsteps, SEIDEL_TI);
+  polybench_stop_instruments;
+
+  polybench_tuned_report("engine: %d rows per band\n", SEIDEL_TI);
+#elif defined(POLYBENCH_TUNED)
+  /* Pipelined wavefront over (t, i, j) tiles. The row bands of tiles are
+     owned cyclically by the threads and walked in (t, band, column) order.
+     The tiles are parallelograms: row i0 + r of a band covers the columns
+     [j0 - r, j1 - r), so when a tile reaches a point, its new left and
+     upper neighbours have been updated (by this tile or the one to the
+     left) and its right and lower ones not yet, as in the lexicographic
+     order of the reference. Each tile counts its completed time steps and
+     only waits on the tiles of the neighbouring bands: the ones above must
+     be at step t + 1, the ones below at step t. This needs SEIDEL_TI <=
+     SEIDEL_TJ, so that these are the three nearest tiles. Every point is
+     thus updated from the same values as in the reference, and no global
+     barrier is needed. */
+  static_assert(SEIDEL_TI <= SEIDEL_TJ, "SEIDEL_TI must not exceed SEIDEL_TJ");
+  const long nn = n;
+  const long nbi = (nn - 2 + SEIDEL_TI - 1) / SEIDEL_TI;
+  const long nbj = (nn - 2 + SEIDEL_TI - 1 + SEIDEL_TJ - 1) / SEIDEL_TJ;
+  std::vector<std::atomic<INT_TYPE>> done(nbi * nbj);
+  for (long b = 0; b < nbi * nbj; b++)
+    done[b].store(0, std::memory_order_relaxed);
+
+  polybench_start_instruments;
+#pragma omp parallel
+  {
+    const long nthreads = omp_get_num_threads();
+    for (INT_TYPE t = 0; t < tsteps; t++)
+      for (long bi = omp_get_thread_num(); bi < nbi; bi += nthreads)
+        for (long bj = 0; bj < nbj; bj++) {
+          const long bj0 = bj > 0 ? bj - 1 : bj;
+          const long bj1 = bj + 1 < nbj ? bj + 1 : bj;
+          for (long b = bj0; b <= bj1; b++) {
+            if (bi > 0)
+              wait_tile(done[(bi - 1) * nbj + b], t + 1);
+            if (bi + 1 < nbi)
+              wait_tile(done[(bi + 1) * nbj + b], t);
+          }
+
+          const long i0 = 1 + bi * SEIDEL_TI;
+          const long i1 = i0 + SEIDEL_TI < nn - 1 ? i0 + SEIDEL_TI : nn - 1;
+          for (long i = i0; i < i1; i++) {
+            long j0 = 1 + bj * SEIDEL_TJ - (i - i0), j1 = j0 + SEIDEL_TJ;
+            j0 = j0 < 1 ? 1 : j0;
+            j1 = j1 > nn - 1 ? nn - 1 : j1;
+            for (long j = j0; j < j1; j++)
+              A[i][j] = (A[i - 1][j - 1] + A[i - 1][j] + A[i - 1][j + 1] +
+                         A[i][j - 1] + A[i][j] + A[i][j + 1] +
+                         A[i + 1][j - 1] + A[i + 1][j] + A[i + 1][j + 1]) /
+                        SCALAR_VAL(9.0);
+          }
+
+          done[bi * nbj + bj].store(t + 1, std::memory_order_release);
+        }
+  }
+  polybench_stop_instruments;
 #else
   polybench_start_instruments;
 #pragma scop
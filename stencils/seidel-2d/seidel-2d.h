@@ -49,6 +49,14 @@
 #define _PB_TSTEPS POLYBENCH_LOOP_BOUND(TSTEPS, tsteps)
 #define _PB_N POLYBENCH_LOOP_BOUND(N, n)
 
+/* Tile sizes (rows x columns) of the tuned variant. */
+#ifndef SEIDEL_TI
+#define SEIDEL_TI 32
+#endif
+#ifndef SEIDEL_TJ
+#define SEIDEL_TJ 256
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) &&              \
     !defined(DATA_TYPE_IS_DOUBLE)
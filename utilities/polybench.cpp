@@ -22,6 +22,18 @@
 #ifdef _OPENMP
 # include <omp.h>
 #endif
+#if defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+# include "polybench_team.h"
+#endif
+#if defined(POLYBENCH_TUNED_MPI)
+# include <mpi.h>
+#endif
+#if (defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)) \
+    && defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+#endif
 
 #if defined(POLYBENCH_PAPI)
 # undef POLYBENCH_PAPI
@@ -387,6 +399,11 @@ void polybench_timer_stop()
 
 void polybench_timer_print()
 {
+#ifdef POLYBENCH_TUNED_MPI
+  /* One line for the whole run, the time of process 0. */
+  if (polybench_mpi_rank () != 0)
+    return;
+#endif
 #ifdef POLYBENCH_GFLOPS
       if  (polybench_program_total_flops == 0)
 	{
@@ -406,6 +423,264 @@ void polybench_timer_print()
 #endif
 }
 
+#ifdef POLYBENCH_TUNED_UTILS
+/*
+ * Average cost, in seconds, of an empty OpenMP parallel region. The
+ * tuned variants use it to report the fork/join overhead they avoid.
+ *
+ */
+double polybench_tuned_fork_join_cost()
+{
+  const int nb_reps = 1000;
+  double t_start = omp_get_wtime ();
+  for (int rep = 0; rep < nb_reps; rep++)
+    {
+#pragma omp parallel
+      {
+	/* Keep the compiler from eliding the empty region. */
+	__asm__ volatile ("" ::: "memory");
+      }
+    }
+  return (omp_get_wtime () - t_start) / nb_reps;
+}
+
+/*
+ * Peak resident set size of the process so far, in bytes. Pages that
+ * were allocated but never touched do not count.
+ *
+ */
+long polybench_tuned_peak_rss()
+{
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) != 0)
+    return 0;
+  /* ru_maxrss is in kilobytes on Linux. */
+  return usage.ru_maxrss * 1024L;
+}
+
+/*
+ * Report the time each thread spent in actual work, and the ratio of
+ * the busiest thread to the average (1.00 is a perfect balance).
+ *
+ */
+void polybench_tuned_report_busy(const double* busy, int nthreads)
+{
+#ifdef POLYBENCH_TUNED_REPORT
+  double sum = 0.0, max = 0.0;
+  polybench_tuned_report ("busy time per thread (s):");
+  for (int t = 0; t < nthreads; t++)
+    {
+      fprintf (stderr, " %0.4f", busy[t]);
+      sum += busy[t];
+      max = busy[t] > max ? busy[t] : max;
+    }
+  fprintf (stderr, ", max/avg %0.2f\n",
+	   sum > 0.0 ? max * nthreads / sum : 1.0);
+#else
+  (void) busy;
+  (void) nthreads;
+#endif
+}
+
+/*
+ * Sustained memory bandwidth, in bytes per second, of a STREAM-like
+ * triad on arrays much larger than the caches. The bandwidth-bound
+ * tuned variants report their own bandwidth against it.
+ *
+ */
+double polybench_tuned_stream_bandwidth()
+{
+  const long n = 1L << 24;
+  const int nb_reps = 5;
+  double* a = (double*) malloc (n * sizeof(double));
+  double* b = (double*) malloc (n * sizeof(double));
+  double* c = (double*) malloc (n * sizeof(double));
+  double best = 0.0;
+  assert (a != NULL && b != NULL && c != NULL);
+
+#pragma omp parallel for schedule(static)
+  for (long i = 0; i < n; i++)
+    {
+      a[i] = 0.0;
+      b[i] = 1.0;
+      c[i] = 2.0;
+    }
+  for (int rep = 0; rep < nb_reps; rep++)
+    {
+      double t_start = omp_get_wtime ();
+#pragma omp parallel for schedule(static)
+      for (long i = 0; i < n; i++)
+	a[i] = b[i] + 3.0 * c[i];
+      double t = omp_get_wtime () - t_start;
+      if (best == 0.0 || t < best)
+	best = t;
+    }
+  free (a);
+  free (b);
+  free (c);
+
+  return 3.0 * n * sizeof(double) / best;
+}
+
+/*
+ * Report the bandwidth of a kernel that moved `bytes` in `seconds`,
+ * against the streaming bandwidth of the machine.
+ *
+ */
+void polybench_tuned_report_bandwidth(double bytes, double seconds)
+{
+#ifdef POLYBENCH_TUNED_REPORT
+  const double stream = polybench_tuned_stream_bandwidth ();
+  polybench_tuned_report ("%0.2f GB/s, %0.0f%% of the %0.2f GB/s streaming "
+			  "bandwidth\n", bytes / seconds * 1e-9,
+			  100.0 * bytes / seconds / stream, stream * 1e-9);
+#else
+  (void) bytes;
+  (void) seconds;
+#endif
+}
+
+/*
+ * Sum the `nparts` thread-private partials of a vector of length n,
+ * stored one after the other in `part`, into the first one. The sum is
+ * a pairwise tree, parallelized over the elements: it must be called by
+ * all the threads of a parallel region, and ends with a barrier.
+ *
+ */
+template <typename T>
+static void polybench_tuned_sum_partials_impl(T* part, long n, int nparts)
+{
+#pragma omp for schedule(static)
+  for (long j = 0; j < n; j++)
+    for (long stride = 1; stride < nparts; stride *= 2)
+      for (long t = 0; t + stride < nparts; t += 2 * stride)
+	part[t * n + j] += part[(t + stride) * n + j];
+}
+
+void polybench_tuned_sum_partials(double* part, long n, int nparts)
+{
+  polybench_tuned_sum_partials_impl (part, n, nparts);
+}
+
+void polybench_tuned_sum_partials(float* part, long n, int nparts)
+{
+  polybench_tuned_sum_partials_impl (part, n, nparts);
+}
+
+void polybench_tuned_sum_partials(int* part, long n, int nparts)
+{
+  polybench_tuned_sum_partials_impl (part, n, nparts);
+}
+
+/*
+ * Last-level cache misses, as a measure of the memory traffic of a
+ * kernel. polybench_tuned_llc_start opens and enables a counter for the
+ * calling process, and returns -1 if the kernel or its permissions do
+ * not allow it. Threads created before the call are not counted, so it
+ * must be called before the first parallel region. polybench_tuned_llc_stop
+ * closes the counter and returns the traffic in bytes (misses times the
+ * cache line size), or -1.
+ *
+ */
+int polybench_tuned_llc_start()
+{
+#if defined(__linux__)
+  struct perf_event_attr attr;
+  memset (&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  int fd = (int) syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0)
+    return -1;
+  ioctl (fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl (fd, PERF_EVENT_IOC_ENABLE, 0);
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+double polybench_tuned_llc_stop(int fd)
+{
+#if defined(__linux__)
+  long long misses;
+  if (fd < 0)
+    return -1.0;
+  ioctl (fd, PERF_EVENT_IOC_DISABLE, 0);
+  ssize_t sz = read (fd, &misses, sizeof(misses));
+  close (fd);
+  if (sz != (ssize_t) sizeof(misses))
+    return -1.0;
+  long line = sysconf (_SC_LEVEL1_DCACHE_LINESIZE);
+  return (double) misses * (line > 0 ? line : 64);
+#else
+  return -1.0;
+#endif
+}
+
+/*
+ * Report the synchronization cost per time step of a persistent team
+ * (polybench_team.h): the time the threads spent waiting, which includes
+ * the load imbalance, the cost of the same number of syncs with no work
+ * in between, and the cost of the fork/joins they replace. `all` tells
+ * whether the syncs were barriers (polybench_team_sync_all) or
+ * polybench_team_sync.
+ *
+ */
+void polybench_tuned_report_sync(const double* wait, int nthreads,
+				 long steps, int syncs_per_step, int all)
+{
+#ifdef POLYBENCH_TUNED_REPORT
+  const int nb_reps = 1000;
+  double sum = 0.0, max = 0.0, t_empty = 0.0;
+  polybench_team team;
+  for (int t = 0; t < nthreads; t++)
+    {
+      sum += wait[t];
+      max = wait[t] > max ? wait[t] : max;
+    }
+#pragma omp parallel num_threads(nthreads)
+  {
+#pragma omp single
+    polybench_team_init (team, omp_get_num_threads ());
+    const int tid = omp_get_thread_num ();
+    double w = 0.0;
+    const double t_start = omp_get_wtime ();
+    for (long s = 1; s <= nb_reps; s++)
+      if (all)
+	polybench_team_sync_all (team, w);
+      else
+	polybench_team_sync (team, tid, s, w);
+    if (tid == 0)
+      t_empty = (omp_get_wtime () - t_start) / nb_reps;
+  }
+#if defined(POLYBENCH_TUNED_BARRIER_SYNC)
+  const char* kind = "barrier";
+#else
+  const char* kind = all ? "barrier" : "neighbour flags";
+#endif
+  steps = steps > 0 ? steps : 1;
+  polybench_tuned_report ("sync per time step (us): wait avg %0.2f max %0.2f,"
+			  " empty %0.2f, fork/join %0.2f (%d sweeps, %s)\n",
+			  sum / nthreads / steps * 1e6, max / steps * 1e6,
+			  t_empty * syncs_per_step * 1e6,
+			  polybench_tuned_fork_join_cost () * syncs_per_step
+			  * 1e6, syncs_per_step, kind);
+#else
+  (void) wait;
+  (void) nthreads;
+  (void) steps;
+  (void) syncs_per_step;
+  (void) all;
+#endif
+}
+#endif
+
 /*
  * These functions are used only if the user defines a specific
  * inter-array padding. It grows a global structure,
@@ -567,3 +842,27 @@ void* polybench_alloc_data(unsigned long long int n, int elt_size)
 
   return ret;
 }
+
+#ifdef POLYBENCH_TUNED_MPI
+/*
+ * MPI setup of the distributed-memory stencils. The processes may run
+ * OpenMP threads, only the master thread calls MPI.
+ */
+void polybench_mpi_init(int* argc, char*** argv)
+{
+  int provided;
+  MPI_Init_thread (argc, argv, MPI_THREAD_FUNNELED, &provided);
+}
+
+void polybench_mpi_finalize()
+{
+  MPI_Finalize ();
+}
+
+int polybench_mpi_rank()
+{
+  int rank;
+  MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+  return rank;
+}
+#endif
@@ -33,6 +33,11 @@
 #include <Kokkos_Core.hpp>
 #endif
 
+#if defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <omp.h>
+#include <stdio.h>
+#endif
+
 /* Array padding. By default, none is used. */
 #ifndef POLYBENCH_PADDING_FACTOR
 /* default: */
@@ -123,9 +128,18 @@
 #define ARRAY_3D_ACCESS(var, i, j, k) var[i][j][k]
 #define ARRAY_4D_ACCESS(var, i, j, k, l) var[i][j][k][l]
 #define ARRAY_5D_ACCESS(var, i, j, k, l, m) var[i][j][k][l][m]
+#if defined(POLYBENCH_TUNED_MPI)
+#define INITIALIZE                                                             \
+  polybench_mpi_init(&argc, &argv);                                            \
+  {
+#define FINALIZE                                                               \
+  }                                                                            \
+  polybench_mpi_finalize();
+#else
 #define INITIALIZE
 #define FINALIZE
 #endif
+#endif
 
 /* Macros to reference an array. Generic for heap and stack arrays
    (C99).  Each array dimensionality has his own macro, to be used at
@@ -334,9 +348,17 @@
 #define POLYBENCH_DUMP_END(s)                                                  \
   fprintf(POLYBENCH_DUMP_TARGET, "\nend   dump: %s\n", s)
 
+#if defined(POLYBENCH_TUNED_MPI)
+/* Only process 0 holds the gathered result. */
+#define polybench_prevent_dce(func)                                            \
+  POLYBENCH_DCE_ONLY_CODE                                                      \
+  if (polybench_mpi_rank() == 0)                                               \
+  func
+#else
 #define polybench_prevent_dce(func)                                            \
   POLYBENCH_DCE_ONLY_CODE                                                      \
   func
+#endif
 
 /* Performance-related instrumentation. See polybench.c */
 #define polybench_start_instruments
@@ -382,6 +404,54 @@ extern void polybench_timer_stop();
 extern void polybench_timer_print();
 #endif
 
+/* The persistent Kokkos stencils share the utilities of the tuned
+   variants (team synchronization and report). */
+#if defined(POLYBENCH_TUNED) || defined(POLYBENCH_KOKKOS_PERSISTENT)
+#define POLYBENCH_TUNED_UTILS
+#endif
+
+/* Breakdown report of the tuned variants. It goes to stderr, after the
+   kernel has been timed, so the timer output is left untouched. Under
+   MPI, only process 0 reports. */
+#if defined(POLYBENCH_TUNED_UTILS) && defined(POLYBENCH_TUNED_REPORT) &&       \
+    defined(POLYBENCH_TUNED_MPI)
+#define polybench_tuned_report(...)                                            \
+  do {                                                                         \
+    if (polybench_mpi_rank() == 0)                                             \
+      fprintf(stderr, "[PolyBench][tuned] " __VA_ARGS__);                      \
+  } while (0)
+#elif defined(POLYBENCH_TUNED_UTILS) && defined(POLYBENCH_TUNED_REPORT)
+#define polybench_tuned_report(...)                                            \
+  fprintf(stderr, "[PolyBench][tuned] " __VA_ARGS__)
+#else
+#define polybench_tuned_report(...)                                            \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#if defined(POLYBENCH_TUNED_UTILS)
+extern double polybench_tuned_fork_join_cost();
+extern long polybench_tuned_peak_rss();
+extern void polybench_tuned_report_busy(const double *busy, int nthreads);
+extern double polybench_tuned_stream_bandwidth();
+extern void polybench_tuned_report_bandwidth(double bytes, double seconds);
+extern void polybench_tuned_sum_partials(double *part, long n, int nparts);
+extern void polybench_tuned_sum_partials(float *part, long n, int nparts);
+extern void polybench_tuned_sum_partials(int *part, long n, int nparts);
+extern int polybench_tuned_llc_start();
+extern double polybench_tuned_llc_stop(int fd);
+extern void polybench_tuned_report_sync(const double *wait, int nthreads,
+                                        long steps, int syncs_per_step,
+                                        int all);
+#endif
+
+/* Distributed-memory variant of the stencils (polybench_mpi.h). */
+#if defined(POLYBENCH_TUNED_MPI)
+extern void polybench_mpi_init(int *argc, char ***argv);
+extern void polybench_mpi_finalize();
+extern int polybench_mpi_rank();
+#endif
+
 /* PAPI support. */
 #ifdef POLYBENCH_PAPI
 extern int polybench_papi_start_counter(int evid);
@@ -0,0 +1,315 @@
+/*
+ * polybench_gemm.h: this file is part of PolyBench/C
+ *
+ * Packed, cache-blocked GEMM building blocks for the tuned variants
+ * (POLYBENCH_TUNED). The layout follows the BLIS/GotoBLAS scheme:
+ *
+ *   for jc in [0, n) step nc       B block (kc x nc) lives in L3
+ *     for pc in [0, k) step kc     pack B(pc, jc) and the m x kc panel A(:, pc)
+ *       for ic in [0, m) step mc   mc x kc block of the A panel in L2
+ *         for jr step NR, ir step MR
+ *           MR x NR register tile, one B sliver (kc x NR) in L1
+ *
+ * polybench_gemm packs all of B up front (polybench_gemm_pack_b_all, which
+ * can be reused across products) and the whole A panel once per (jc, pc),
+ * so that the (ic, jr) blocks can be shared by the threads;
+ * polybench_gemm_seq packs one B block and one mc x kc block of A at a
+ * time.
+ *
+ * mc, kc and nc are derived from the cache sizes reported by the system.
+ * Matrices are described by a base pointer and a row/column stride, so
+ * that transposed operands need no copy.
+ */
+#pragma once
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include <omp.h>
+
+/* Register tile: MR rows of C times one vector of NR elements. */
+#define POLYBENCH_GEMM_MR 6
+#define POLYBENCH_GEMM_VEC_BYTES 64
+
+struct polybench_gemm_blocking {
+  long mc, kc, nc;
+};
+
+static inline long polybench_cache_size(int name, long fallback) {
+  long size = sysconf(name);
+  return size > 0 ? size : fallback;
+}
+
+/* Blocking parameters for elements of elt_size bytes: a pair of A and B
+   slivers fills half of L1, the packed A block half of L2 and the packed
+   B block half of L3. */
+static inline polybench_gemm_blocking
+polybench_gemm_get_blocking(long elt_size) {
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / elt_size;
+  const long mr = POLYBENCH_GEMM_MR;
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+  const long l1 = polybench_cache_size(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+  const long l2 = polybench_cache_size(_SC_LEVEL2_CACHE_SIZE, 256 << 10);
+  const long l3 = polybench_cache_size(_SC_LEVEL3_CACHE_SIZE, 8 << 20);
+#else
+  const long l1 = 32 << 10, l2 = 256 << 10, l3 = 8 << 20;
+#endif
+  polybench_gemm_blocking blk;
+  blk.kc = l1 / 2 / ((mr + nr) * elt_size);
+  blk.kc = blk.kc < 64 ? 64 : blk.kc > 1024 ? 1024 : blk.kc & ~7L;
+  blk.mc = l2 / 2 / (blk.kc * elt_size);
+  /* mc must be a multiple of MR: the blocks of the packed A panel start
+     on sliver boundaries. */
+  blk.mc = blk.mc < mr     ? mr
+           : blk.mc > 1024 ? 1024 / mr * mr
+                           : blk.mc / mr * mr;
+  blk.nc = l3 / 2 / (blk.kc * elt_size);
+  blk.nc = blk.nc < nr ? nr : blk.nc > 8192 ? 8192 : blk.nc / nr * nr;
+  return blk;
+}
+
+/* Pack the mc x kc block of A (scaled by alpha) into slivers of MR rows,
+   each stored as kc consecutive columns of MR elements, zero padded. */
+template <typename T>
+static inline void polybench_gemm_pack_a(long mc, long kc, const T *A,
+                                         long rsa, long csa, T alpha,
+                                         T *Ap) {
+  const long mr = POLYBENCH_GEMM_MR;
+  for (long is = 0; is < mc; is += mr) {
+    const long mb = mc - is < mr ? mc - is : mr;
+    T *dst = &Ap[is * kc];
+    for (long p = 0; p < kc; p++)
+      for (long r = 0; r < mr; r++)
+        dst[p * mr + r] =
+            r < mb ? alpha * A[(is + r) * rsa + p * csa] : T(0);
+  }
+}
+
+/* Pack the kc x nc block of B into slivers of NR columns, each stored as
+   kc consecutive rows of NR elements, zero padded. */
+template <typename T>
+static inline void polybench_gemm_pack_b(long kc, long nc, const T *B,
+                                         long rsb, long csb, T *Bp) {
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / sizeof(T);
+  for (long js = 0; js < nc; js += nr) {
+    const long nb = nc - js < nr ? nc - js : nr;
+    T *dst = &Bp[js * kc];
+    for (long p = 0; p < kc; p++)
+      for (long c = 0; c < nr; c++)
+        dst[p * nr + c] = c < nb ? B[p * rsb + (js + c) * csb] : T(0);
+  }
+}
+
+/* C(mb x nb) = beta * C + Ap * Bp on one MR x NR register tile, with the
+   accumulators held in MR vector registers. */
+template <typename T>
+static inline void polybench_gemm_ukernel(long kc, const T *Ap, const T *Bp,
+                                          T beta, T *C, long ldc, long mb,
+                                          long nb) {
+  typedef T vec __attribute__((vector_size(POLYBENCH_GEMM_VEC_BYTES)));
+  const long mr = POLYBENCH_GEMM_MR;
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / sizeof(T);
+
+  vec acc[POLYBENCH_GEMM_MR];
+  for (long r = 0; r < mr; r++)
+    acc[r] = vec{};
+  for (long p = 0; p < kc; p++) {
+    vec b;
+    memcpy(&b, &Bp[p * nr], sizeof(vec));
+    for (long r = 0; r < mr; r++)
+      acc[r] += Ap[p * mr + r] * b;
+  }
+
+  if (mb == mr && nb == nr) {
+    for (long r = 0; r < mr; r++) {
+      vec c;
+      memcpy(&c, &C[r * ldc], sizeof(vec));
+      c = beta * c + acc[r];
+      memcpy(&C[r * ldc], &c, sizeof(vec));
+    }
+  } else {
+    for (long r = 0; r < mb; r++)
+      for (long c = 0; c < nb; c++)
+        C[r * ldc + c] = beta * C[r * ldc + c] + acc[r][c];
+  }
+}
+
+/* Multiply the packed mc x kc block of A by the packed kc x nc block of B
+   into C, one register tile at a time (the jr / ir loops). */
+template <typename T>
+static inline void polybench_gemm_macro_kernel(long mc, long nc, long kc,
+                                               const T *Ap, const T *Bp,
+                                               T beta, T *C, long ldc) {
+  const long mr = POLYBENCH_GEMM_MR;
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / sizeof(T);
+  for (long jr = 0; jr < nc; jr += nr)
+    for (long ir = 0; ir < mc; ir += mr)
+      polybench_gemm_ukernel(kc, &Ap[ir * kc], &Bp[jr * kc], beta,
+                             &C[ir * ldc + jr], ldc,
+                             mc - ir < mr ? mc - ir : mr,
+                             nc - jr < nr ? nc - jr : nr);
+}
+
+/* Single-threaded version of polybench_gemm below, for use inside of a
+   parallel region. Ap and Bp are the caller's packing buffers, grown as
+   needed, so that a thread can reuse them across calls. */
+template <typename T>
+static void polybench_gemm_seq(long m, long n, long k, T alpha, const T *A,
+                               long rsa, long csa, const T *B, long rsb,
+                               long csb, T beta, T *C, long ldc,
+                               std::vector<T> &Ap, std::vector<T> &Bp) {
+  const polybench_gemm_blocking blk = polybench_gemm_get_blocking(sizeof(T));
+  const long mr = POLYBENCH_GEMM_MR;
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / sizeof(T);
+  const long mc_max = m < blk.mc ? (m + mr - 1) / mr * mr : blk.mc;
+  const long kc_max = k < blk.kc ? k : blk.kc;
+  const long nc_max = n < blk.nc ? (n + nr - 1) / nr * nr : blk.nc;
+  if (Ap.size() < (size_t)(mc_max * kc_max))
+    Ap.resize(mc_max * kc_max);
+  if (Bp.size() < (size_t)(nc_max * kc_max))
+    Bp.resize(nc_max * kc_max);
+
+  if (k == 0) {
+    for (long i = 0; i < m; i++)
+      for (long j = 0; j < n; j++)
+        C[i * ldc + j] *= beta;
+    return;
+  }
+
+  for (long jc = 0; jc < n; jc += blk.nc) {
+    const long nc = n - jc < blk.nc ? n - jc : blk.nc;
+    for (long pc = 0; pc < k; pc += blk.kc) {
+      const long kc = k - pc < blk.kc ? k - pc : blk.kc;
+      const T beta_pc = pc == 0 ? beta : T(1);
+      polybench_gemm_pack_b(kc, nc, &B[pc * rsb + jc * csb], rsb, csb,
+                            Bp.data());
+      for (long ic = 0; ic < m; ic += blk.mc) {
+        const long mc = m - ic < blk.mc ? m - ic : blk.mc;
+        polybench_gemm_pack_a(mc, kc, &A[ic * rsa + pc * csa], rsa, csa,
+                              alpha, Ap.data());
+        polybench_gemm_macro_kernel(mc, nc, kc, Ap.data(), Bp.data(),
+                                    beta_pc, &C[ic * ldc + jc], ldc);
+      }
+    }
+  }
+}
+
+/* Tile (bi, bj), bj <= bi, of index t in the row-major enumeration of the
+   lower triangle of tiles. */
+static inline void polybench_tri_tile(unsigned long t, unsigned long *bi,
+                                      unsigned long *bj) {
+  unsigned long i = (unsigned long)((sqrt(8.0 * t + 1.0) - 1.0) / 2.0);
+  while (i * (i + 1) / 2 > t)
+    i--;
+  while ((i + 1) * (i + 2) / 2 <= t)
+    i++;
+  *bi = i;
+  *bj = t - i * (i + 1) / 2;
+}
+
+/* B (k x n) packed once for several products by polybench_gemm_packed:
+   the (jc, pc) blocks of polybench_gemm, each laid out as
+   polybench_gemm_pack_b does, block (jc, pc) at offset jc * k + pc * ncp,
+   with ncp its width padded to NR. */
+template <typename T> struct polybench_gemm_packed_b {
+  long k, n;
+  polybench_gemm_blocking blk;
+  std::vector<T> data;
+};
+
+/* Pack B(p, j) = B[p * rsb + j * csb], k x n. Must be called from outside
+   of a parallel region: the slivers are distributed over the threads. */
+template <typename T>
+static void polybench_gemm_pack_b_all(long k, long n, const T *B, long rsb,
+                                      long csb,
+                                      polybench_gemm_packed_b<T> &Bp) {
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / sizeof(T);
+  Bp.k = k;
+  Bp.n = n;
+  Bp.blk = polybench_gemm_get_blocking(sizeof(T));
+  Bp.data.resize((n + nr - 1) / nr * nr * k);
+  const long nc_blk = Bp.blk.nc, kc_blk = Bp.blk.kc;
+  T *data = Bp.data.data();
+
+#pragma omp parallel for collapse(2) schedule(static)
+  for (long js = 0; js < n; js += nr)
+    for (long pc = 0; pc < k; pc += kc_blk) {
+      const long jc = js / nc_blk * nc_blk;
+      const long nc = n - jc < nc_blk ? n - jc : nc_blk;
+      const long ncp = (nc + nr - 1) / nr * nr;
+      const long kc = k - pc < kc_blk ? k - pc : kc_blk;
+      polybench_gemm_pack_b(kc, n - js < nr ? n - js : nr,
+                            &B[pc * rsb + js * csb], rsb, csb,
+                            &data[jc * k + pc * ncp + (js - jc) * kc]);
+    }
+}
+
+/* C = beta * C + alpha * A * B, with B packed by polybench_gemm_pack_b_all
+   and the rest as for polybench_gemm below. Only the A panels are packed,
+   so a B reused across calls (e.g. for several row blocks of A) is packed
+   once. Must be called from outside of a parallel region. */
+template <typename T>
+static void polybench_gemm_packed(long m, T alpha, const T *A, long rsa,
+                                  long csa,
+                                  const polybench_gemm_packed_b<T> &Bp,
+                                  T beta, T *C, long ldc) {
+  const polybench_gemm_blocking &blk = Bp.blk;
+  const long n = Bp.n, k = Bp.k;
+  const long mr = POLYBENCH_GEMM_MR;
+  const long nr = POLYBENCH_GEMM_VEC_BYTES / sizeof(T);
+  const long kc_max = k < blk.kc ? k : blk.kc;
+  /* Column split of the B block, so that small m still feeds all
+     threads. */
+  const long nc_sub = 4 * nr;
+  std::vector<T> Ap((m + mr - 1) / mr * mr * kc_max);
+
+  if (k == 0) {
+#pragma omp parallel for
+    for (long i = 0; i < m; i++)
+      for (long j = 0; j < n; j++)
+        C[i * ldc + j] *= beta;
+    return;
+  }
+
+#pragma omp parallel
+  for (long jc = 0; jc < n; jc += blk.nc) {
+    const long nc = n - jc < blk.nc ? n - jc : blk.nc;
+    const long ncp = (nc + nr - 1) / nr * nr;
+    for (long pc = 0; pc < k; pc += blk.kc) {
+      const long kc = k - pc < blk.kc ? k - pc : blk.kc;
+      const T beta_pc = pc == 0 ? beta : T(1);
+      const T *Bb = &Bp.data[jc * k + pc * ncp];
+
+#pragma omp for schedule(static)
+      for (long is = 0; is < m; is += mr)
+        polybench_gemm_pack_a(m - is < mr ? m - is : mr, kc,
+                              &A[is * rsa + pc * csa], rsa, csa, alpha,
+                              &Ap[is * kc]);
+
+#pragma omp for collapse(2) schedule(dynamic)
+      for (long ic = 0; ic < m; ic += blk.mc)
+        for (long jr = 0; jr < nc; jr += nc_sub) {
+          const long mc = m - ic < blk.mc ? m - ic : blk.mc;
+          polybench_gemm_macro_kernel(mc, nc - jr < nc_sub ? nc - jr : nc_sub,
+                                      kc, &Ap[ic * kc], &Bb[jr * kc], beta_pc,
+                                      &C[ic * ldc + jc + jr], ldc);
+        }
+    }
+  }
+}
+
+/* C = beta * C + alpha * A * B, with C row-major (m x n, leading dimension
+   ldc), A(i, p) = A[i * rsa + p * csa] and B(p, j) = B[p * rsb + j * csb].
+   Must be called from outside of a parallel region: B and then each A
+   panel are packed cooperatively, and the (ic, jr) blocks of C are
+   distributed over the threads. */
+template <typename T>
+static void polybench_gemm(long m, long n, long k, T alpha, const T *A,
+                           long rsa, long csa, const T *B, long rsb,
+                           long csb, T beta, T *C, long ldc) {
+  polybench_gemm_packed_b<T> Bp;
+  polybench_gemm_pack_b_all(k, n, B, rsb, csb, Bp);
+  polybench_gemm_packed(m, alpha, A, rsa, csa, Bp, beta, C, ldc);
+}
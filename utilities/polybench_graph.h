@@ -0,0 +1,77 @@
+/*
+ * polybench_graph.h: this file is part of PolyBench/C
+ *
+ * Graph replay of the Kokkos stencils (POLYBENCH_KOKKOS_GRAPH). The
+ * parallel_fors of one time step are captured once in a
+ * Kokkos::Experimental::Graph, and the time loop only submits the graph,
+ * instead of building and dispatching every kernel again.
+ *
+ * With POLYBENCH_TUNED_REPORT, polybench_graph_report measures what this
+ * saves: the same sequence of policies, with empty bodies, is run for a
+ * number of time steps both dispatched one by one and replayed from a
+ * graph. The difference per time step is the dispatch overhead removed.
+ */
+#pragma once
+
+#include <stdio.h>
+
+#include <Kokkos_Core.hpp>
+
+/* Number of time steps of the dispatch measurement. */
+#ifndef POLYBENCH_GRAPH_REPS
+#define POLYBENCH_GRAPH_REPS 1000
+#endif
+
+/* Body of the calibration kernels, for any rank of policy. */
+struct polybench_graph_empty {
+  template <class... I> KOKKOS_INLINE_FUNCTION void operator()(I...) const {}
+};
+
+/* Append one empty kernel per policy to `node`, in sequence. */
+template <class Node> static inline void polybench_graph_chain(const Node &) {}
+
+template <class Node, class P, class... Ps>
+static inline void polybench_graph_chain(const Node &node, const P &p,
+                                         const Ps &...ps) {
+  polybench_graph_chain(node.then_parallel_for(p, polybench_graph_empty()),
+                        ps...);
+}
+
+/* Print on stderr the dispatch time of a time step made of one kernel per
+   policy, launched one by one and replayed from a graph. Does nothing
+   without POLYBENCH_TUNED_REPORT. */
+template <class P, class... Ps>
+static inline void polybench_graph_report(const P &p, const Ps &...ps) {
+#if defined(POLYBENCH_TUNED_REPORT)
+  typedef typename P::execution_space exec;
+  const int nkernels = 1 + sizeof...(Ps);
+
+  Kokkos::Timer timer;
+  for (long s = 0; s < POLYBENCH_GRAPH_REPS; s++) {
+    Kokkos::parallel_for(p, polybench_graph_empty());
+    (Kokkos::parallel_for(ps, polybench_graph_empty()), ...);
+  }
+  Kokkos::fence();
+  const double eager = timer.seconds() / POLYBENCH_GRAPH_REPS;
+
+  timer.reset();
+  auto graph = Kokkos::Experimental::create_graph(
+      exec(), [&](const auto &root) { polybench_graph_chain(root, p, ps...); });
+  const double build = timer.seconds();
+  timer.reset();
+  for (long s = 0; s < POLYBENCH_GRAPH_REPS; s++)
+    graph.submit();
+  Kokkos::fence();
+  const double replay = timer.seconds() / POLYBENCH_GRAPH_REPS;
+
+  fprintf(stderr,
+          "[PolyBench][graph] %d kernels per time step: dispatch %0.2f us "
+          "launched, %0.2f us replayed, %0.2f us removed per time step "
+          "(graph built in %0.2f us)\n",
+          nkernels, eager * 1e6, replay * 1e6, (eager - replay) * 1e6,
+          build * 1e6);
+#else
+  (void)p;
+  ((void)ps, ...);
+#endif
+}
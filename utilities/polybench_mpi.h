@@ -0,0 +1,313 @@
+/*
+ * polybench_mpi.h: this file is part of PolyBench/C
+ *
+ * Domain decomposition for the distributed-memory variant of the tuned
+ * stencils (POLYBENCH_TUNED_MPI). The grid is split in blocks over a
+ * Cartesian grid of processes (MPI_Dims_create). Each process keeps its
+ * block with one layer of ghost cells on every side, in a local array of
+ * extents ln[d] = hi[d] - lo[d] + 2, and exchanges the faces of the block
+ * with its neighbours. The faces are described by subarray datatypes, so
+ * nothing is packed by hand.
+ *
+ * The exchange is non-blocking (polybench_mpi_sweep): it is posted, the
+ * points that read no ghost cell are updated, then the rim once the
+ * halos have arrived. The times spent computing, posting and waiting are
+ * accumulated in the grid for the report.
+ *
+ * Every process holds the full arrays of the benchmark, as initialized by
+ * init_array. It copies its block from them before the kernel, and
+ * polybench_mpi_gather sends the blocks back to process 0 for
+ * print_array.
+ */
+#pragma once
+
+#include <mpi.h>
+
+#include <initializer_list>
+#include <vector>
+
+template <typename T> static inline MPI_Datatype polybench_mpi_type();
+template <> inline MPI_Datatype polybench_mpi_type<double>() {
+  return MPI_DOUBLE;
+}
+template <> inline MPI_Datatype polybench_mpi_type<float>() {
+  return MPI_FLOAT;
+}
+template <> inline MPI_Datatype polybench_mpi_type<int>() { return MPI_INT; }
+
+/* A box of global indices [lo[d], hi[d]). */
+struct polybench_mpi_box {
+  long lo[3], hi[3];
+};
+
+struct polybench_mpi_grid {
+  int dims;
+  MPI_Comm comm;
+  int rank, size;
+  int pdims[3], coords[3];
+  long n[3];         /* global extents */
+  long lo[3], hi[3]; /* block of this process */
+  long ln[3];        /* local extents, with the ghost layers */
+  int nbr[3][2];     /* neighbours on the low and high side of each dim. */
+  MPI_Datatype face_send[3][2], face_recv[3][2];
+  double t_comp, t_post, t_wait;
+  long halo_bytes; /* sent per exchange */
+};
+
+/* Local extents as int, for the MPI datatypes. */
+static inline void polybench_mpi_local_sizes(const polybench_mpi_grid &g,
+                                             int sizes[3]) {
+  for (int d = 0; d < g.dims; d++)
+    sizes[d] = (int)g.ln[d];
+}
+
+/* Split the global grid n[0..dims) over all the processes. */
+static inline void polybench_mpi_grid_init(polybench_mpi_grid &g, int dims,
+                                           const long n[], MPI_Datatype elt) {
+  int periods[3] = {0, 0, 0};
+  g.dims = dims;
+  MPI_Comm_size(MPI_COMM_WORLD, &g.size);
+  for (int d = 0; d < 3; d++)
+    g.pdims[d] = 0;
+  MPI_Dims_create(g.size, dims, g.pdims);
+  MPI_Cart_create(MPI_COMM_WORLD, dims, g.pdims, periods, 0, &g.comm);
+  MPI_Comm_rank(g.comm, &g.rank);
+  MPI_Cart_coords(g.comm, g.rank, dims, g.coords);
+  for (int d = 0; d < 3; d++) {
+    g.n[d] = d < dims ? n[d] : 1;
+    g.lo[d] = d < dims ? g.n[d] * g.coords[d] / g.pdims[d] : 0;
+    g.hi[d] = d < dims ? g.n[d] * (g.coords[d] + 1) / g.pdims[d] : 1;
+    g.ln[d] = g.hi[d] - g.lo[d] + 2;
+  }
+  g.halo_bytes = 0;
+  int esize;
+  MPI_Type_size(elt, &esize);
+  for (int d = 0; d < dims; d++) {
+    MPI_Cart_shift(g.comm, d, 1, &g.nbr[d][0], &g.nbr[d][1]);
+    for (int side = 0; side < 2; side++) {
+      int sizes[3], subsizes[3], starts[3];
+      polybench_mpi_local_sizes(g, sizes);
+      long face = 1;
+      for (int e = 0; e < dims; e++) {
+        subsizes[e] = e == d ? 1 : sizes[e] - 2;
+        starts[e] = 1;
+        face *= subsizes[e];
+      }
+      starts[d] = side == 0 ? 1 : sizes[d] - 2;
+      MPI_Type_create_subarray(dims, sizes, subsizes, starts, MPI_ORDER_C, elt,
+                               &g.face_send[d][side]);
+      MPI_Type_commit(&g.face_send[d][side]);
+      starts[d] = side == 0 ? 0 : sizes[d] - 1;
+      MPI_Type_create_subarray(dims, sizes, subsizes, starts, MPI_ORDER_C, elt,
+                               &g.face_recv[d][side]);
+      MPI_Type_commit(&g.face_recv[d][side]);
+      if (g.nbr[d][side] != MPI_PROC_NULL)
+        g.halo_bytes += face * esize;
+    }
+  }
+  g.t_comp = g.t_post = g.t_wait = 0.0;
+}
+
+static inline void polybench_mpi_grid_free(polybench_mpi_grid &g) {
+  for (int d = 0; d < g.dims; d++)
+    for (int side = 0; side < 2; side++) {
+      MPI_Type_free(&g.face_send[d][side]);
+      MPI_Type_free(&g.face_recv[d][side]);
+    }
+  MPI_Comm_free(&g.comm);
+}
+
+/* Offset in the local array of the global point (i, j, k). */
+static inline long polybench_mpi_local(const polybench_mpi_grid &g, long i,
+                                       long j = 0, long k = 0) {
+  long off = i - g.lo[0] + 1;
+  if (g.dims > 1)
+    off = off * g.ln[1] + (j - g.lo[1] + 1);
+  if (g.dims > 2)
+    off = off * g.ln[2] + (k - g.lo[2] + 1);
+  return off;
+}
+
+static inline long polybench_mpi_local_size(const polybench_mpi_grid &g) {
+  return g.ln[0] * (g.dims > 1 ? g.ln[1] : 1) * (g.dims > 2 ? g.ln[2] : 1);
+}
+
+/* Copy the block of this process from the full array `full` into `local`.
+   ld[0] and ld[1] are the strides, in elements, of the first two
+   dimensions of `full`, whose last dimension is contiguous: {lda, 1} in
+   2-D, {ldi, ldj} in 3-D. */
+template <typename T>
+static inline void polybench_mpi_scatter(const polybench_mpi_grid &g,
+                                         const T *full, const long ld[2],
+                                         T *local) {
+  for (long i = g.lo[0]; i < g.hi[0]; i++)
+    for (long j = g.lo[1]; j < g.hi[1]; j++)
+      for (long k = g.lo[2]; k < g.hi[2]; k++)
+        local[polybench_mpi_local(g, i, j, k)] =
+            full[i * ld[0] + j * ld[1] + k];
+}
+
+/* Send the blocks of every process back into `full` on process 0. ld is
+   as for polybench_mpi_scatter. */
+template <typename T>
+static inline void polybench_mpi_gather(const polybench_mpi_grid &g,
+                                        const T *local, T *full,
+                                        const long ld[2], MPI_Datatype elt) {
+  int sizes[3], subsizes[3], starts[3];
+  MPI_Datatype block;
+  polybench_mpi_local_sizes(g, sizes);
+  for (int d = 0; d < g.dims; d++) {
+    subsizes[d] = (int)(g.hi[d] - g.lo[d]);
+    starts[d] = 1;
+  }
+  MPI_Type_create_subarray(g.dims, sizes, subsizes, starts, MPI_ORDER_C, elt,
+                           &block);
+  MPI_Type_commit(&block);
+  MPI_Request sreq;
+  MPI_Isend(local, 1, block, 0, 0, g.comm, &sreq);
+
+  if (g.rank == 0) {
+    /* The full array is n[0] x ld[0] in 2-D, n[0] x ld[0] / ld[1] x ld[1]
+       in 3-D. */
+    int fsizes[3] = {(int)g.n[0], (int)(ld[0] / ld[1]), (int)ld[1]};
+    for (int r = 0; r < g.size; r++) {
+      int c[3], fsub[3], fstart[3];
+      MPI_Cart_coords(g.comm, r, g.dims, c);
+      for (int d = 0; d < g.dims; d++) {
+        const long lo = g.n[d] * c[d] / g.pdims[d];
+        const long hi = g.n[d] * (c[d] + 1) / g.pdims[d];
+        fsub[d] = (int)(hi - lo);
+        fstart[d] = (int)lo;
+      }
+      MPI_Datatype dst;
+      MPI_Type_create_subarray(g.dims, fsizes, fsub, fstart, MPI_ORDER_C, elt,
+                               &dst);
+      MPI_Type_commit(&dst);
+      MPI_Recv(full, 1, dst, r, 0, g.comm, MPI_STATUS_IGNORE);
+      MPI_Type_free(&dst);
+    }
+  }
+  MPI_Wait(&sreq, MPI_STATUS_IGNORE);
+  MPI_Type_free(&block);
+}
+
+/* Post the exchange of the faces of `a`: 4 * dims requests. */
+template <typename T>
+static inline void polybench_mpi_halo_start(polybench_mpi_grid &g, T *a,
+                                            MPI_Request *req) {
+  const double t_start = MPI_Wtime();
+  int nreq = 0;
+  for (int d = 0; d < g.dims; d++) {
+    /* Faces going down (tag 2d) and up (tag 2d + 1). */
+    MPI_Irecv(a, 1, g.face_recv[d][1], g.nbr[d][1], 2 * d, g.comm,
+              &req[nreq++]);
+    MPI_Irecv(a, 1, g.face_recv[d][0], g.nbr[d][0], 2 * d + 1, g.comm,
+              &req[nreq++]);
+    MPI_Isend(a, 1, g.face_send[d][0], g.nbr[d][0], 2 * d, g.comm,
+              &req[nreq++]);
+    MPI_Isend(a, 1, g.face_send[d][1], g.nbr[d][1], 2 * d + 1, g.comm,
+              &req[nreq++]);
+  }
+  g.t_post += MPI_Wtime() - t_start;
+}
+
+static inline void polybench_mpi_halo_wait(polybench_mpi_grid &g, int nreq,
+                                           MPI_Request *req) {
+  const double t_start = MPI_Wtime();
+  MPI_Waitall(nreq, req, MPI_STATUSES_IGNORE);
+  g.t_wait += MPI_Wtime() - t_start;
+}
+
+/* Split the points of `range` (global) owned by this process into the
+   interior, whose neighbours are all owned, and up to 2 * dims rim boxes
+   along the faces shared with another process. Returns the number of
+   boxes written to `rim`. */
+static inline int polybench_mpi_split(const polybench_mpi_grid &g,
+                                      const polybench_mpi_box &range,
+                                      polybench_mpi_box &interior,
+                                      polybench_mpi_box rim[6]) {
+  polybench_mpi_box own;
+  for (int d = 0; d < 3; d++) {
+    own.lo[d] = range.lo[d] > g.lo[d] ? range.lo[d] : g.lo[d];
+    own.hi[d] = range.hi[d] < g.hi[d] ? range.hi[d] : g.hi[d];
+    if (own.hi[d] < own.lo[d])
+      own.hi[d] = own.lo[d];
+  }
+  interior = own;
+  int nrim = 0;
+  for (int d = 0; d < g.dims; d++) {
+    /* Peel the faces of dimension d off what is left of the interior. */
+    if (g.nbr[d][0] != MPI_PROC_NULL && interior.lo[d] == g.lo[d] &&
+        interior.lo[d] < interior.hi[d]) {
+      rim[nrim] = interior;
+      rim[nrim++].hi[d] = interior.lo[d] + 1;
+      interior.lo[d]++;
+    }
+    if (g.nbr[d][1] != MPI_PROC_NULL && interior.hi[d] == g.hi[d] &&
+        interior.lo[d] < interior.hi[d]) {
+      rim[nrim] = interior;
+      rim[nrim++].lo[d] = interior.hi[d] - 1;
+      interior.hi[d]--;
+    }
+  }
+  return nrim;
+}
+
+/* Update the points of `range` owned by this process with update(box),
+   overlapped with the exchange of the halos of the arrays `halos`: the
+   interior first, then the rim once the halos have arrived. */
+template <typename T, class F>
+static inline void polybench_mpi_sweep(polybench_mpi_grid &g,
+                                       std::initializer_list<T *> halos,
+                                       const polybench_mpi_box &range,
+                                       const F &update) {
+  std::vector<MPI_Request> req(4 * g.dims * halos.size());
+  int k = 0;
+  for (T *a : halos)
+    polybench_mpi_halo_start(g, a, &req[4 * g.dims * k++]);
+  polybench_mpi_box interior, rim[6];
+  const int nrim = polybench_mpi_split(g, range, interior, rim);
+  double t_start = MPI_Wtime();
+  update(interior);
+  g.t_comp += MPI_Wtime() - t_start;
+  polybench_mpi_halo_wait(g, (int)req.size(), req.data());
+  t_start = MPI_Wtime();
+  for (int r = 0; r < nrim; r++)
+    update(rim[r]);
+  g.t_comp += MPI_Wtime() - t_start;
+}
+
+/* Report, on process 0, the average and max over the processes of the
+   compute, post and halo wait times, the gather time, and the volume of
+   the halos. */
+static inline void polybench_mpi_report(const polybench_mpi_grid &g,
+                                        int exchanges_per_step,
+                                        double t_gather) {
+#if defined(POLYBENCH_TUNED_REPORT)
+  double mine[4] = {g.t_comp, g.t_post, g.t_wait, t_gather};
+  double sum[4], max[4];
+  MPI_Reduce(mine, sum, 4, MPI_DOUBLE, MPI_SUM, 0, g.comm);
+  MPI_Reduce(mine, max, 4, MPI_DOUBLE, MPI_MAX, 0, g.comm);
+  long bytes = g.halo_bytes, bytes_sum;
+  MPI_Reduce(&bytes, &bytes_sum, 1, MPI_LONG, MPI_SUM, 0, g.comm);
+  if (g.rank != 0)
+    return;
+  if (g.dims == 2)
+    polybench_tuned_report("mpi: %d processes, grid %dx%d\n", g.size,
+                           g.pdims[0], g.pdims[1]);
+  else
+    polybench_tuned_report("mpi: %d processes, grid %dx%dx%d\n", g.size,
+                           g.pdims[0], g.pdims[1], g.pdims[2]);
+  polybench_tuned_report("mpi: compute %0.4f s (max %0.4f), halo post "
+                         "%0.4f s (max %0.4f), halo wait %0.4f s (max "
+                         "%0.4f), gather %0.4f s\n",
+                         sum[0] / g.size, max[0], sum[1] / g.size, max[1],
+                         sum[2] / g.size, max[2], max[3]);
+  polybench_tuned_report("mpi: %0.3f MB of halos per time step\n",
+                         (double)bytes_sum * exchanges_per_step * 1e-6);
+#else
+  (void)g;
+  (void)exchanges_per_step;
+  (void)t_gather;
+#endif
+}
@@ -0,0 +1,341 @@
+/*
+ * polybench_stencil.h: this file is part of PolyBench/C
+ *
+ * Compile-time stencil engine for the tuned variants (POLYBENCH_TUNED,
+ * engine variant with POLYBENCH_TUNED_ENGINE). A stencil is described
+ * once, as a small struct:
+ *
+ *   struct my_stencil {
+ *     static constexpr int dims = 2, radius = 1;
+ *     static constexpr polybench_stencil_update update =
+ *         POLYBENCH_STENCIL_JACOBI;
+ *     template <class P> double operator()(const P &a) const {
+ *       return 0.25 * (a(-1, 0) + a(1, 0) + a(0, -1) + a(0, 1));
+ *     }
+ *   };
+ *
+ * where a(d0, d1, d2) reads the neighbour at that offset, with dimension
+ * dims - 1 contiguous in memory. Linear stencils can instead list their
+ * taps as constexpr weights (polybench_stencil_linear). The offsets and
+ * weights are constants, so each point compiles to a fixed expression.
+ *
+ * Single-field stencils are swept over the interior [radius, n - radius)
+ * of every dimension:
+ *
+ *   - Jacobi (polybench_stencil_jacobi): two arrays, swapped after each
+ *     sweep. Sweeps are grouped into bands of ts, skewed by radius along
+ *     dimension 0 and cut into parallelogram tiles of bi planes. The
+ *     bands are owned cyclically by the threads and pipelined: tile
+ *     (T, I) waits for tile (T - 1, I + 1), which is enough as long as
+ *     bi >= radius * ts. Within a tile, the sweeps run one after the
+ *     other. ts = 1 gives plain, pipelined sweeps. The rows along the last
+ *     dimension are vectorized.
+ *   - Gauss-Seidel (polybench_stencil_gauss_seidel): in place, in
+ *     lexicographic order. Bands of bi >= radius planes are pipelined
+ *     over the threads, band b at sweep t waiting for band b - 1 at sweep
+ *     t and band b + 1 at sweep t - 1.
+ *
+ * Both compute every point from the same values as the sequential sweep,
+ * in the order written in operator(), so the result is identical.
+ *
+ * Coupled fields (e.g. fdtd-2d) are described as a list of stages, each
+ * updating one field in place from the others (polybench_stencil_stages).
+ * The stages run in a persistent team (polybench_team.h) over static
+ * bands along dimension 0, synchronized only where a stage reads across a
+ * band a field written since the last sync, or writes a field read that
+ * way.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "polybench_team.h"
+
+enum polybench_stencil_update {
+  POLYBENCH_STENCIL_JACOBI,
+  POLYBENCH_STENCIL_GAUSS_SEIDEL
+};
+
+/* Extents n[0..2] of the grid (1 for the missing dimensions) and strides,
+   in elements, of dimensions 0 and 1. The last used dimension has stride
+   1, so a 1-D grid has ld[0] = 1 and a 2-D grid ld[1] = 1. */
+struct polybench_stencil_shape {
+  long n[3];
+  long ld[2];
+};
+
+/* Neighbours of one point of a single field. */
+template <typename T> struct polybench_stencil_point {
+  const T *p;
+  long s0, s1;
+  T operator()(int d0, int d1 = 0, int d2 = 0) const {
+    return p[d0 * s0 + d1 * s1 + d2];
+  }
+};
+
+/* One tap of a linear stencil: offset and weight. */
+struct polybench_stencil_tap {
+  int d0, d1, d2;
+  double w;
+};
+
+/* Linear stencil scale * sum(w * a(d)), from a description with
+   `static constexpr polybench_stencil_tap taps[]` and `scale`. The taps
+   are summed left to right, in the order listed. */
+template <typename T, class D> struct polybench_stencil_linear : D {
+  static constexpr int ntaps = sizeof(D::taps) / sizeof(D::taps[0]);
+
+  template <class P, std::size_t... K>
+  static T sum(const P &a, std::index_sequence<K...>) {
+    T s = T(0);
+    ((s = K == 0 ? T(D::taps[K].w) * a(D::taps[K].d0, D::taps[K].d1,
+                                       D::taps[K].d2)
+                 : s + T(D::taps[K].w) * a(D::taps[K].d0, D::taps[K].d1,
+                                           D::taps[K].d2)),
+     ...);
+    return s;
+  }
+
+  template <class P> T operator()(const P &a) const {
+    return T(D::scale) * sum(a, std::make_index_sequence<ntaps>());
+  }
+};
+
+/* Update dst[base + k], k in [lo, hi), from src (src == dst in place). */
+template <class S, typename T>
+static inline void polybench_stencil_row(const S &s, const T *src, T *dst,
+                                         long base, long lo, long hi,
+                                         long s0, long s1) {
+  if constexpr (S::update == POLYBENCH_STENCIL_JACOBI) {
+#pragma omp simd
+    for (long k = lo; k < hi; k++)
+      dst[base + k] = s(polybench_stencil_point<T>{&src[base + k], s0, s1});
+  } else {
+    for (long k = lo; k < hi; k++)
+      dst[base + k] = s(polybench_stencil_point<T>{&src[base + k], s0, s1});
+  }
+}
+
+/* Update the planes [i0, i1) of dimension 0, over the whole interior of
+   the other dimensions. */
+template <class S, typename T>
+static inline void polybench_stencil_planes(const S &s, const T *src, T *dst,
+                                            long i0, long i1,
+                                            const polybench_stencil_shape &g) {
+  constexpr long r = S::radius;
+  if constexpr (S::dims == 1) {
+    polybench_stencil_row(s, src, dst, 0, i0, i1, 1, 0);
+  } else if constexpr (S::dims == 2) {
+    for (long i = i0; i < i1; i++)
+      polybench_stencil_row(s, src, dst, i * g.ld[0], r, g.n[1] - r, g.ld[0],
+                            1);
+  } else {
+    for (long i = i0; i < i1; i++)
+      for (long j = r; j < g.n[1] - r; j++)
+        polybench_stencil_row(s, src, dst, i * g.ld[0] + j * g.ld[1], r,
+                              g.n[2] - r, g.ld[0], g.ld[1]);
+  }
+}
+
+static inline void polybench_stencil_wait(const std::atomic<long> &done,
+                                          long count) {
+  for (long spin = 0; done.load(std::memory_order_acquire) < count; spin++)
+    if (spin > 1024)
+      std::this_thread::yield();
+}
+
+/* nsweeps Jacobi sweeps: sweep g reads a and writes b when g is even, the
+   other way around when g is odd. ts sweeps per band, bi planes per tile
+   (raised to radius * ts). */
+template <class S, typename T>
+static void polybench_stencil_jacobi(const S &s, T *a, T *b,
+                                     const polybench_stencil_shape &g,
+                                     long nsweeps, long ts, long bi) {
+  static_assert(S::update == POLYBENCH_STENCIL_JACOBI,
+                "polybench_stencil_jacobi needs a Jacobi stencil");
+  constexpr long r = S::radius;
+  const long H = ts < 1 ? 1 : ts;
+  const long BI = bi > r * H ? bi : r * H;
+  const long n0 = g.n[0];
+  if (nsweeps <= 0 || n0 <= 2 * r)
+    return;
+  const long nbands = (nsweeps + H - 1) / H;
+  const long nbi = (n0 - r - 1 + r * (H - 1)) / BI + 1;
+  std::vector<std::atomic<long>> done(nbi);
+  for (long I = 0; I < nbi; I++)
+    done[I].store(0, std::memory_order_relaxed);
+
+#pragma omp parallel
+  {
+    const long nt = omp_get_num_threads();
+    for (long band = omp_get_thread_num(); band < nbands; band += nt)
+      for (long I = 0; I < nbi; I++) {
+        polybench_stencil_wait(done[I + 1 < nbi ? I + 1 : I], band);
+        const long g0 = band * H;
+        const long hb = nsweeps - g0 < H ? nsweeps - g0 : H;
+        for (long h = 0; h < hb; h++) {
+          const long x0 = I * BI - r * h, x1 = (I + 1) * BI - r * h;
+          const long i0 = x0 > r ? x0 : r;
+          const long i1 = x1 < n0 - r ? x1 : n0 - r;
+          if (i0 >= i1)
+            continue;
+          if ((g0 + h) % 2 == 0)
+            polybench_stencil_planes(s, a, b, i0, i1, g);
+          else
+            polybench_stencil_planes(s, b, a, i0, i1, g);
+        }
+        done[I].store(band + 1, std::memory_order_release);
+      }
+  }
+}
+
+/* nsweeps in-place Gauss-Seidel sweeps, bands of bi planes (raised to
+   radius). */
+template <class S, typename T>
+static void polybench_stencil_gauss_seidel(const S &s, T *a,
+                                           const polybench_stencil_shape &g,
+                                           long nsweeps, long bi) {
+  static_assert(S::update == POLYBENCH_STENCIL_GAUSS_SEIDEL,
+                "polybench_stencil_gauss_seidel needs a Gauss-Seidel stencil");
+  constexpr long r = S::radius;
+  const long BI = bi > r ? bi : r;
+  const long n0 = g.n[0];
+  if (nsweeps <= 0 || n0 <= 2 * r)
+    return;
+  const long nb = (n0 - 2 * r + BI - 1) / BI;
+  std::vector<std::atomic<long>> done(nb);
+  for (long b = 0; b < nb; b++)
+    done[b].store(0, std::memory_order_relaxed);
+
+#pragma omp parallel
+  {
+    const long nt = omp_get_num_threads();
+    for (long t = 0; t < nsweeps; t++)
+      for (long b = omp_get_thread_num(); b < nb; b += nt) {
+        if (b > 0)
+          polybench_stencil_wait(done[b - 1], t + 1);
+        if (b + 1 < nb)
+          polybench_stencil_wait(done[b + 1], t);
+        const long i0 = r + b * BI;
+        const long i1 = i0 + BI < n0 - r ? i0 + BI : n0 - r;
+        polybench_stencil_planes(s, a, a, i0, i1, g);
+        done[b].store(t + 1, std::memory_order_release);
+      }
+  }
+}
+
+/* Fields of a point, for the stages of coupled stencils. */
+template <typename T, int NF> struct polybench_stencil_fields {
+  T *const *f;
+  long base, s0, s1;
+};
+
+/* Field F of the point p, at offset (d0, d1, d2). */
+template <int F, typename T, int NF>
+static inline T polybench_stencil_at(const polybench_stencil_fields<T, NF> &p,
+                                     int d0, int d1 = 0, int d2 = 0) {
+  return p.f[F][p.base + d0 * p.s0 + d1 * p.s1 + d2];
+}
+
+/* Run one stage on the planes [i0, i1) of dimension 0 at time step t. A
+   stage describes:
+
+     static constexpr int dims, radius;  reach along dimension 0
+     static constexpr int field;         field it writes
+     static constexpr unsigned halo;     mask of the fields it reads at a
+                                         non-zero offset along dimension 0
+     static void range(const long n[3], long lo[3], long hi[3]);
+     T operator()(const polybench_stencil_fields<T, NF> &p, long t) const;
+
+   The written field may only be read at offset 0, so the points of a
+   stage are independent and vectorized. */
+template <class S, typename T, int NF>
+static inline void polybench_stencil_stage(const S &s, T *const *f, long i0,
+                                           long i1,
+                                           const polybench_stencil_shape &g,
+                                           long t) {
+  long lo[3], hi[3];
+  S::range(g.n, lo, hi);
+  i0 = i0 > lo[0] ? i0 : lo[0];
+  i1 = i1 < hi[0] ? i1 : hi[0];
+  T *dst = f[S::field];
+  if constexpr (S::dims == 1) {
+#pragma omp simd
+    for (long i = i0; i < i1; i++)
+      dst[i] = s(polybench_stencil_fields<T, NF>{f, i, 1, 0}, t);
+  } else if constexpr (S::dims == 2) {
+    for (long i = i0; i < i1; i++) {
+      const long base = i * g.ld[0];
+#pragma omp simd
+      for (long k = lo[1]; k < hi[1]; k++)
+        dst[base + k] =
+            s(polybench_stencil_fields<T, NF>{f, base + k, g.ld[0], 1}, t);
+    }
+  } else {
+    for (long i = i0; i < i1; i++)
+      for (long j = lo[1]; j < hi[1]; j++) {
+        const long base = i * g.ld[0] + j * g.ld[1];
+#pragma omp simd
+        for (long k = lo[2]; k < hi[2]; k++)
+          dst[base + k] = s(
+              polybench_stencil_fields<T, NF>{f, base + k, g.ld[0], g.ld[1]},
+              t);
+      }
+  }
+}
+
+/* Synchronization of a run of stages, for polybench_tuned_report_sync. */
+struct polybench_stencil_sync {
+  int nthreads;
+  long syncs;
+  std::vector<double> wait;
+};
+
+/* tsteps time steps of the stages, in order, on the fields f[0..NF). */
+template <typename T, int NF, class... S>
+static void polybench_stencil_stages(T *const (&f)[NF],
+                                     const polybench_stencil_shape &g,
+                                     long tsteps, polybench_stencil_sync &sync,
+                                     const S &...stages) {
+  constexpr int reach = std::max({1, S::radius...});
+  const long n0 = g.n[0];
+  const long nt_cap = n0 / reach > 0 ? n0 / reach : 1;
+  const int nt_max =
+      omp_get_max_threads() < nt_cap ? omp_get_max_threads() : (int)nt_cap;
+  polybench_team team;
+  sync.wait.assign(nt_max, 0.0);
+
+#pragma omp parallel num_threads(nt_max)
+  {
+#pragma omp single
+    polybench_team_init(team, omp_get_num_threads());
+    const int nt = team.nthreads, tid = omp_get_thread_num();
+    const long i0 = n0 * tid / nt, i1 = n0 * (tid + 1) / nt;
+    unsigned written = 0, halo = 0;
+    long step = 0;
+    double w = 0.0;
+    auto run = [&](const auto &s, long t) {
+      using St = std::decay_t<decltype(s)>;
+      if ((St::halo & written) || ((1u << St::field) & halo)) {
+        polybench_team_sync(team, tid, ++step, w);
+        written = halo = 0;
+      }
+      polybench_stencil_stage<St, T, NF>(s, f, i0, i1, g, t);
+      written |= 1u << St::field;
+      halo |= St::halo;
+    };
+    for (long t = 0; t < tsteps; t++)
+      (run(stages, t), ...);
+    sync.wait[tid] = w;
+    if (tid == 0)
+      sync.syncs = step;
+  }
+  sync.nthreads = team.nthreads;
+}
@@ -0,0 +1,141 @@
+/*
+ * polybench_team.h: this file is part of PolyBench/C
+ *
+ * Synchronization of a persistent thread team, for the persistent mode of
+ * the tuned stencils (POLYBENCH_TUNED_PERSISTENT) and of the Kokkos
+ * stencils (POLYBENCH_KOKKOS_PERSISTENT). The whole time loop runs in one
+ * parallel region, each thread keeps the same static block of the domain
+ * at every time step, and the sweeps are separated by either:
+ *
+ *   - a sense-reversing barrier on one counter (polybench_team_barrier),
+ *     for sweeps whose blocks exchange data with every other block;
+ *   - per-thread progress flags (polybench_team_neighbours), when a block
+ *     only reads the blocks next to it. A thread then waits for its two
+ *     neighbours only, so adjacent threads are never more than one sweep
+ *     apart and a late thread does not hold up the whole team.
+ *
+ * The waits spin on the cache line of the flag, then yield, so that an
+ * oversubscribed team still makes progress.
+ */
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <omp.h>
+
+#if defined(POLYBENCH_KOKKOS_PERSISTENT)
+#include <Kokkos_Core.hpp>
+#endif
+
+/* Progress of one thread: the number of sweeps it has completed. Each
+   flag has its own cache line, so that polling a neighbour does not
+   invalidate the line of another. */
+struct alignas(64) polybench_team_flag {
+  std::atomic<long> step;
+};
+
+struct polybench_team {
+  int nthreads;
+  std::vector<polybench_team_flag> flags;
+  alignas(64) std::atomic<int> arrived;
+  alignas(64) std::atomic<long> generation;
+};
+
+/* Set up the team for nthreads threads. Must be called by one thread of
+   the parallel region, before a barrier, e.g. in an omp single. */
+static inline void polybench_team_init(polybench_team &team, int nthreads) {
+  team.nthreads = nthreads;
+  team.flags = std::vector<polybench_team_flag>(nthreads);
+  for (int t = 0; t < nthreads; t++)
+    team.flags[t].step.store(0, std::memory_order_relaxed);
+  team.arrived.store(0, std::memory_order_relaxed);
+  team.generation.store(0, std::memory_order_relaxed);
+}
+
+static inline void polybench_team_wait(const std::atomic<long> &flag,
+                                       long step) {
+  for (long spin = 0; flag.load(std::memory_order_acquire) < step; spin++)
+    if (spin > 1024)
+      std::this_thread::yield();
+}
+
+/* Wait until every thread of the team has reached the barrier. The last
+   thread to arrive resets the counter and releases the others by bumping
+   the generation. */
+static inline void polybench_team_barrier(polybench_team &team) {
+  const long gen = team.generation.load(std::memory_order_relaxed);
+  if (team.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      team.nthreads) {
+    team.arrived.store(0, std::memory_order_relaxed);
+    team.generation.store(gen + 1, std::memory_order_release);
+  } else
+    polybench_team_wait(team.generation, gen + 1);
+}
+
+/* Publish that thread tid has completed sweep `step` (counted from 1),
+   then wait until the threads tid - 1 and tid + 1 have completed it too. */
+static inline void polybench_team_neighbours(polybench_team &team, int tid,
+                                             long step) {
+  team.flags[tid].step.store(step, std::memory_order_release);
+  if (tid > 0)
+    polybench_team_wait(team.flags[tid - 1].step, step);
+  if (tid + 1 < team.nthreads)
+    polybench_team_wait(team.flags[tid + 1].step, step);
+}
+
+/* End of sweep `step` for a block that only reads its neighbours. The
+   flags are used unless POLYBENCH_TUNED_BARRIER_SYNC is defined. With
+   POLYBENCH_TUNED_REPORT, the time spent waiting is added to `wait`. */
+static inline void polybench_team_sync(polybench_team &team, int tid,
+                                       long step, double &wait) {
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+#endif
+#if defined(POLYBENCH_TUNED_BARRIER_SYNC)
+  (void)tid;
+  (void)step;
+  polybench_team_barrier(team);
+#else
+  polybench_team_neighbours(team, tid, step);
+#endif
+#if defined(POLYBENCH_TUNED_REPORT)
+  wait += omp_get_wtime() - t_start;
+#else
+  (void)wait;
+#endif
+}
+
+/* End of a sweep whose blocks read the whole domain: always a barrier. */
+static inline void polybench_team_sync_all(polybench_team &team,
+                                           double &wait) {
+#if defined(POLYBENCH_TUNED_REPORT)
+  const double t_start = omp_get_wtime();
+  polybench_team_barrier(team);
+  wait += omp_get_wtime() - t_start;
+#else
+  (void)wait;
+  polybench_team_barrier(team);
+#endif
+}
+
+#if defined(POLYBENCH_KOKKOS_PERSISTENT)
+/* Run body(tid, nthreads) once on every member of a single Kokkos team of
+   the OpenMP backend, after setting up `team` for them. The members of a
+   team are distinct threads that run concurrently, so unlike the indices
+   of a RangePolicy they can wait on each other. The team is as large as
+   the backend allows, at most its concurrency. */
+template <class F>
+static inline void polybench_team_kokkos(polybench_team &team, const F &body) {
+  typedef Kokkos::TeamPolicy<Kokkos::OpenMP> policy;
+  const auto member = [&](const policy::member_type &m) {
+    body(m.team_rank(), m.team_size());
+  };
+  const int max = policy(1, 1).team_size_max(member, Kokkos::ParallelForTag());
+  const int concurrency = Kokkos::OpenMP().concurrency();
+  polybench_team_init(team, concurrency < max ? concurrency : max);
+  Kokkos::parallel_for(policy(1, team.nthreads), member);
+  Kokkos::fence();
+}
+#endif